@@ -1,4 +1,19 @@
+/* `clock_gettime` of the Linux backend is POSIX, hidden by strict ISO C modes (e.g. `-std=c11`). */
+#if defined(__linux__) && !defined(_POSIX_C_SOURCE) && !defined(_GNU_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
 #include "stpmic.h"
+#include <string.h>
+
+#if STPMIC_USE_LINUX
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+#endif
 
 /* default address for STPMIC1. */
 #define STPMIC1_DEF_ADDR    0x33u
@@ -10,32 +25,114 @@ enum {
     STPMIC_DRV_READY,
 };
 
-/* register map, pairs of { start id, max id }. */
-const uint8_t STPMIC_REGMAP[] = {
-    STPMIC_REG_TURN_ON_SR,      STPMIC_REG_VERSION_SR + 1,
-    STPMIC_REG_MAIN_CR,         STPMIC_REG_PKEY_TURNOFF_CR + 1,
-    STPMIC_REG_BUCKS_MRST_CR,   STPMIC_REG_BUCKS_MRST_CR + 1,
-    STPMIC_REG_LDOS_MRST_CR,    STPMIC_REG_WDG_TMR_CR + 1,
-    STPMIC_REG_BUCKx_MAIN_CR,   STPMIC_REG_BUCKx_MAIN_CR + 4,
-    STPMIC_REG_LDOx_MAIN_CR,    STPMIC_REG_LDOx_MAIN_CR + 6,
-    0, 0
+/* maximum spans that are transferred together. */
+#define STPMIC_SPAN_MAX     16
+
+/* maximum registers to read through between spans, a byte is cheaper than a new transfer. */
+#define STPMIC_SPAN_GAP     3
+
+#if STPMIC_IRQ_RING & (STPMIC_IRQ_RING - 1) || STPMIC_IRQ_RING > 128
+#error "STPMIC_IRQ_RING must be a power of 2, up to 128."
+#endif
+
+#if STPMIC_EVLOG_SIZE & (STPMIC_EVLOG_SIZE - 1) || STPMIC_EVLOG_SIZE > 128
+#error "STPMIC_EVLOG_SIZE must be a power of 2, up to 128."
+#endif
+
+#if STPMIC_TXN_MAX > STPMIC_SPAN_MAX
+#error "STPMIC_TXN_MAX can't exceed STPMIC_SPAN_MAX."
+#endif
+
+/* buffer of spans that are read together, the cache has no room for gaps between them. */
+#define STPMIC_SPAN_BUF     (4 * STPMIC_BURST_MAX)
+
+/* a contiguous register range to transfer. */
+typedef struct {
+    uint8_t             reg;
+    uint8_t             len;
+    stpmic_reg_t*       buf;
+} stpmic_span_t;
+
+/* shorthands of register attributes. */
+#define STPMIC_RA_STATUS    (STPMIC_REGATTR_RO | STPMIC_REGATTR_VOLATILE)
+#define STPMIC_RA_ACTION    (STPMIC_REGATTR_W1C)
+
+/* attributes of cached registers, from `STPMIC_CACHED_REGS`. */
+#define STPMIC_RA_CACHED(name, reg, attr)   [reg] = (attr) | STPMIC_REGATTR_CACHE,
+
+/* register attributes, unlisted addresses are reserved. */
+const uint8_t STPMIC_REGATTR[STPMIC_REG_MAX] = {
+    /* status registers, VERSION_SR never changes and is cached. */
+    [STPMIC_REG_TURN_ON_SR]         = STPMIC_RA_STATUS,
+    [STPMIC_REG_TURN_OFF_SR]        = STPMIC_RA_STATUS,
+    [STPMIC_REG_OCP_LDOS_SR]        = STPMIC_RA_STATUS,
+    [STPMIC_REG_OCP_BUCKS_BSW_SR]   = STPMIC_RA_STATUS,
+    [STPMIC_REG_RESTART_SR]         = STPMIC_RA_STATUS,
+
+    /* control registers, WDG_CR's reset bit clears itself. */
+    [STPMIC_REG_WDG_CR]             = STPMIC_REGATTR_VOLATILE,
+
+    /* cached registers: control, power supplies, alternative mode, INT_MASK_Rx and NVM shadow registers. */
+    STPMIC_CACHED_REGS(STPMIC_RA_CACHED)
+
+    /* interrupt registers, INT_MASK_Rx is cached and changed by INT_MASK_SET_Rx and INT_MASK_CLEAR_Rx. */
+    [STPMIC_REG_INT_PENDING_R1]     = STPMIC_RA_STATUS,
+    [STPMIC_REG_INT_PENDING_R2]     = STPMIC_RA_STATUS,
+    [STPMIC_REG_INT_PENDING_R3]     = STPMIC_RA_STATUS,
+    [STPMIC_REG_INT_PENDING_R4]     = STPMIC_RA_STATUS,
+    [STPMIC_REG_INT_DBG_LATCH_R1]   = STPMIC_RA_STATUS,
+    [STPMIC_REG_INT_DBG_LATCH_R2]   = STPMIC_RA_STATUS,
+    [STPMIC_REG_INT_DBG_LATCH_R3]   = STPMIC_RA_STATUS,
+    [STPMIC_REG_INT_DBG_LATCH_R4]   = STPMIC_RA_STATUS,
+    [STPMIC_REG_INT_CLEAR_R1]       = STPMIC_RA_ACTION,
+    [STPMIC_REG_INT_CLEAR_R2]       = STPMIC_RA_ACTION,
+    [STPMIC_REG_INT_CLEAR_R3]       = STPMIC_RA_ACTION,
+    [STPMIC_REG_INT_CLEAR_R4]       = STPMIC_RA_ACTION,
+    [STPMIC_REG_INT_MASK_SET_R1]    = STPMIC_RA_ACTION,
+    [STPMIC_REG_INT_MASK_SET_R2]    = STPMIC_RA_ACTION,
+    [STPMIC_REG_INT_MASK_SET_R3]    = STPMIC_RA_ACTION,
+    [STPMIC_REG_INT_MASK_SET_R4]    = STPMIC_RA_ACTION,
+    [STPMIC_REG_INT_MASK_CLEAR_R1]  = STPMIC_RA_ACTION,
+    [STPMIC_REG_INT_MASK_CLEAR_R2]  = STPMIC_RA_ACTION,
+    [STPMIC_REG_INT_MASK_CLEAR_R3]  = STPMIC_RA_ACTION,
+    [STPMIC_REG_INT_MASK_CLEAR_R4]  = STPMIC_RA_ACTION,
+    [STPMIC_REG_INT_SRC_R1]         = STPMIC_RA_STATUS,
+    [STPMIC_REG_INT_SRC_R2]         = STPMIC_RA_STATUS,
+    [STPMIC_REG_INT_SRC_R3]         = STPMIC_RA_STATUS,
+    [STPMIC_REG_INT_SRC_R4]         = STPMIC_RA_STATUS,
+
+    /* NVM registers, NVM_CR's opcode clears itself, shadow registers are cached. */
+    [STPMIC_REG_NVM_SR]             = STPMIC_RA_STATUS,
+    [STPMIC_REG_NVM_CR]             = STPMIC_REGATTR_VOLATILE,
+};
+
+/* slot entry of a cached register, stored as `slot + 1`. */
+#define STPMIC_SLOT_ENTRY(name, reg, attr)  [reg] = STPMIC_SLOT_##name + 1,
+
+/* address to slot map of the cache, zero if not cached. */
+static const uint8_t STPMIC_REGSLOT[STPMIC_REG_MAX] = {
+    STPMIC_CACHED_REGS(STPMIC_SLOT_ENTRY)
 };
 
-/* STPMIC driver status. */
-static struct {
-#if !STPMIC_USE_CUSTOM
-    stpmic_i2c_t*       dev;
+/* test whether the register is served from the cache or not. */
+#define STPMIC_IS_CACHED(reg)   (STPMIC_REGSLOT[reg] != 0)
+
+/* slot of a cached register. */
+#define STPMIC_SLOT(reg)        (STPMIC_REGSLOT[reg] - 1u)
+
+/* test whether a cached register takes the slot after the one of the previous address, bursts from the cache need it. */
+#define STPMIC_SLOT_FOLLOWS(reg)    (STPMIC_IS_CACHED((reg) - 1) && STPMIC_SLOT(reg) == STPMIC_SLOT((reg) - 1) + 1u)
+
+#if STPMIC_USE_ASYNC && STPMIC_ASYNC_DMA
+#define STPMIC_HAL_READ_ASYNC   HAL_I2C_Mem_Read_DMA
+#define STPMIC_HAL_WRITE_ASYNC  HAL_I2C_Mem_Write_DMA
+#elif STPMIC_USE_ASYNC
+#define STPMIC_HAL_READ_ASYNC   HAL_I2C_Mem_Read_IT
+#define STPMIC_HAL_WRITE_ASYNC  HAL_I2C_Mem_Write_IT
 #endif
-    int16_t             addr;
-    uint8_t             state;
 
-    /* read/write timeout. */
-    uint32_t            timeout_r;
-    uint32_t            timeout_w;
-    
-    /* cache: (MSB) xxxx xxxS VVVV VVVV (LSB). */
-    uint16_t            cache[STPMIC_REG_CACHE_MAX];
-} STPMIC1 = {
+/* the default context. */
+stpmic_ctx_t stpmic_default_ctx = {
 #if !STPMIC_USE_CUSTOM
     .dev = NULL,
 #endif
@@ -43,1159 +140,3834 @@ static struct {
     .state = 0,
     .timeout_r = STPMIC_INIT_DELAY,
     .timeout_w = STPMIC_INIT_DELAY,
-    .cache = { 0, }
+    .cache = { 0, },
+    .valid = { 0, },
+    .dirty = { 0, },
+    .owned = { 0, },
+    .status = { 0, },
+    .status_known = 0,
+    .restarts = 0,
+    .skips = 0,
+    .hits = 0,
+    .misses = 0,
+    .ahead = 0
 };
 
-/* cache mismatch bit, if set, the cached value should be ignored. */
-#define STPMIC_CACHE_MISMATCH   (1u << 8)
+/* bitmap accessors, by slot. */
+#define STPMIC_SLOT_TEST(map, n)     ((map)[(n) >> 3] & (1u << ((n) & 7)))
+#define STPMIC_SLOT_SET(map, n)      ((map)[(n) >> 3] |= (uint8_t)(1u << ((n) & 7)))
+#define STPMIC_SLOT_CLR(map, n)      ((map)[(n) >> 3] &= (uint8_t)~(1u << ((n) & 7)))
 
-/* set timeout of STPMIC driver. */
-void stpmic_set_timeout(stpmic_timeout_t* in) {
-    if (!in) {
-        return;
-    }
+/* dirty bitmap accessors, the register must be cached. */
+#define STPMIC_IS_DIRTY(ctx, reg)    STPMIC_SLOT_TEST((ctx)->dirty, STPMIC_SLOT(reg))
+#define STPMIC_SET_DIRTY(ctx, reg)   STPMIC_SLOT_SET((ctx)->dirty, STPMIC_SLOT(reg))
+#define STPMIC_CLR_DIRTY(ctx, reg)   STPMIC_SLOT_CLR((ctx)->dirty, STPMIC_SLOT(reg))
 
-    STPMIC1.timeout_w = in->write;
-    STPMIC1.timeout_r = in->read;
-}
+/* cached value of a register, meaningful only if `__stpmic_cache_hit` is true. */
+#define STPMIC_CACHE_VAL(ctx, reg)   ((ctx)->cache[STPMIC_SLOT(reg)])
 
-void stpmic_get_timeout(stpmic_timeout_t* out) {
-    if (out) {
-        out->write = STPMIC1.timeout_w;
-        out->read = STPMIC1.timeout_r;
-    }
-}
+/* reason bits of `RESTART_SR` for restart checks, `OP_MODE` and `LDO4_SRC` are live state. */
+#define STPMIC_RESTARTSR_REASONS    0x1fu
 
-#if STPMIC_USE_CUSTOM
-/* initialize the STPMIC driver. */
-stpmic_ret_t stpmic_init(int16_t addr) {
-    if (addr > 0x7fu) {
-        return STPMIC_RET_INVALID;
-    }
+/* self-clearing command bits of a cached register, they're never cached nor re-applied. */
+#define STPMIC_CMD_BITS(reg)        ((reg) == STPMIC_REG_MAIN_CR ? STPMIC_MAINCR_SWOFF : 0u)
+
+/* count trailing zeros of a non-zero value. */
+#if defined(__GNUC__) || defined(__clang__)
+#define STPMIC_CTZ(x)   ((uint8_t) __builtin_ctzl((unsigned long)(x)))
 #else
-/* initialize the STPMIC driver. */
-stpmic_ret_t stpmic_init(stpmic_i2c_t* dev, int16_t addr) {
-    if (!dev || addr > 0x7f) {
-        return STPMIC_RET_INVALID;
-    }
-#endif
-    if (STPMIC1.state != STPMIC_DRV_NOT_INIT) {
-        return STPMIC_RET_ALREADY;
-    }
+static uint8_t __stpmic_ctz(uint32_t x) {
+    static const uint8_t DEBRUIJN[32] = {
+        0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8,
+        31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9
+    };
+
+    // --> isolate the lowest bit, then hash it.
+    return DEBRUIJN[((x & (0u - x)) * 0x077CB531u) >> 27];
+}
 
-#if !STPMIC_USE_HAL && !STPMIC_USE_CUSTOM
-    if (!dev->read_i2c || !dev->write_i2c) {
-        return STPMIC_RET_NOTSUP;
-    }
+#define STPMIC_CTZ(x)   __stpmic_ctz(x)
 #endif
 
-    if (addr < 0) {
-        addr = STPMIC1_DEF_ADDR;
-    }
-
-    uint8_t version_sr;
-    stpmic_ret_t ret;
+#if STPMIC_USE_LOCK
+/* take and release the lock of the context. */
+#define STPMIC_LOCK(ctx)        stpmic_ctx_lock(ctx)
+#define STPMIC_UNLOCK(ctx)      stpmic_ctx_unlock(ctx)
 
-#if !STPMIC_USE_CUSTOM
-    STPMIC1.dev = dev;
+/* begin and end to update the cache, readers retry while the sequence is odd or changed. */
+#define STPMIC_SEQ_BEGIN(ctx)   do { (ctx)->seq++; STPMIC_BARRIER(); } while (0)
+#define STPMIC_SEQ_END(ctx)     do { STPMIC_BARRIER(); (ctx)->seq++; } while (0)
+#else
+#define STPMIC_LOCK(ctx)
+#define STPMIC_UNLOCK(ctx)
+#define STPMIC_SEQ_BEGIN(ctx)
+#define STPMIC_SEQ_END(ctx)
 #endif
-    STPMIC1.addr = addr;
-    STPMIC1.state = STPMIC_DRV_INIT;
-    
-    // --> read VERSION_SR register.
-    ret = stpmic_read_direct(STPMIC_REG_VERSION_SR, &version_sr);
 
-    // --> failed to read.
-    if (ret != STPMIC_RET_OK) {
-        STPMIC1.state = STPMIC_DRV_NOT_INIT;
-        return ret;
-    }
+#if STPMIC_USE_RETAIN
+/* magic of the retained image, changes with the layout of the cache and what is retained. */
+#define STPMIC_RETAIN_MAGIC     (0x53520000u | STPMIC_CACHE_SLOTS)
 
-    // --> not supported MAJOR version.
-    if ((version_sr & 0xf0) != (STPMIC1_MAJOR_VER << 4)) {
-        STPMIC1.state = STPMIC_DRV_NOT_INIT;
-        return STPMIC_RET_NOTSUP;
-    }
+/* drop command bits from retained values, they must not be replayed after an MCU reset. */
+#define STPMIC_RETAIN_STRIP(cache)  \
+    ((cache)[STPMIC_SLOT_MAIN_CR] &= (stpmic_reg_t) ~STPMIC_CMD_BITS(STPMIC_REG_MAIN_CR))
 
-    // --> make register caches.
-    if (stpmic_reload_cache() != STPMIC_RET_OK) {
-        STPMIC1.state = STPMIC_DRV_NOT_INIT;
-        return STPMIC_RET_UNKNOWN;
-    }
-    
-    STPMIC1.state = STPMIC_DRV_READY;
-    return STPMIC_RET_OK;
-}
+/* registers probed by a single burst on warm start, `BUCKx_MAIN_CR` ~ `LDOx_MAIN_CR`. */
+#define STPMIC_PROBE_REG        STPMIC_REG_BUCKx_MAIN_CR
+#define STPMIC_PROBE_LEN        (STPMIC_REG_LDOx_MAIN_CR + 6 - STPMIC_REG_BUCKx_MAIN_CR)
 
-/* read a register of STPMIC without cache. */
-stpmic_ret_t stpmic_read_direct(stpmic_regid_t _reg, stpmic_reg_t* out) {
-    if (STPMIC1.state < STPMIC_DRV_INIT) {
-        return STPMIC_RET_NODEV;
-    }
-    
-    if (_reg >= STPMIC_REG_MAX) {
-        return STPMIC_RET_INVALID;
-    }
+#if STPMIC_PROBE_LEN > STPMIC_BURST_MAX
+#error "probed registers should fit in a single burst."
+#endif
 
-    uint8_t val = 0;
-    uint8_t reg = _reg;
+/* CRC-16/CCITT of the retained image, from `addr` to the end of `cache`. */
+static uint16_t __stpmic_retain_crc(const stpmic_retain_t* area) {
+    const uint8_t* p = (const uint8_t*) area + offsetof(stpmic_retain_t, addr);
+    const uint8_t* end = (const uint8_t*) area + offsetof(stpmic_retain_t, cache) + sizeof(area->cache);
+    uint16_t crc = 0xffffu;
 
-#if STPMIC_USE_HAL
-    // --> transmit a `read` packet.
-    HAL_StatusTypeDef ret = HAL_I2C_Master_Transmit(
-        STPMIC1.dev, (STPMIC1.addr << 1) | 0, 
-        &reg, sizeof(reg), STPMIC1.timeout_r);
+    for (; p < end; ++p) {
+        crc ^= (uint16_t)(*p << 8);
 
-    if (ret != HAL_OK) {
-        return STPMIC_RET_TIMEOUT;
+        for (uint8_t i = 0; i < 8; ++i) {
+            crc = (crc & 0x8000u) 
+                ? (uint16_t)((crc << 1) ^ 0x1021u) 
+                : (uint16_t)(crc << 1);
+        }
     }
 
-    // --> then, receive register values.
-    ret = HAL_I2C_Master_Receive(
-        STPMIC1.dev, (STPMIC1.addr << 1) | 1, 
-        &val, sizeof(val), STPMIC1.timeout_r);
+    return crc;
+}
 
-    if (ret != HAL_OK) {
-        return STPMIC_RET_TIMEOUT;
+/* update the retained image after the cache is changed. */
+static void __stpmic_retain_sync(stpmic_ctx_t* ctx) {
+    stpmic_retain_t* area = ctx->retain;
+
+    if (!area || ctx->state < STPMIC_DRV_INIT) {
+        return;
     }
-#elif STPMIC_USE_CUSTOM
-    uint8_t ret = stpmic_write_i2c((STPMIC1.addr << 1) | 0, 
-        &reg, sizeof(reg), STPMIC1.timeout_r);
 
-    if (ret != sizeof(reg)) {
-        return STPMIC_RET_TIMEOUT;
+    // --> pending batch writes are not on the device yet.
+    for (uint8_t i = 0; i < sizeof(area->valid); ++i) {
+        area->valid[i] = ctx->valid[i] & (uint8_t) ~ctx->dirty[i];
     }
 
-    // --> then, receive register values.
-    ret = stpmic_read_i2c((STPMIC1.addr << 1) | 1, 
-        &val, sizeof(val), STPMIC1.timeout_r);
+    memcpy(area->cache, ctx->cache, sizeof(area->cache));
+    STPMIC_RETAIN_STRIP(area->cache);
+    memcpy(area->owned, ctx->owned, sizeof(area->owned));
+    memcpy(area->status, ctx->status, sizeof(area->status));
+    area->status_known = ctx->status_known;
+    area->addr = (uint8_t) ctx->addr;
+    area->gen = ctx->gen;
+    area->crc = __stpmic_retain_crc(area);
+    area->magic = STPMIC_RETAIN_MAGIC;
+}
 
-    if (ret != sizeof(val)) {
-        return STPMIC_RET_TIMEOUT;
+/* invalidate the retained image until the next sync, writes may be interrupted by an MCU reset. */
+static void __stpmic_retain_hold(stpmic_ctx_t* ctx) {
+    if (ctx->retain) {
+        ctx->retain->magic = 0;
     }
+}
+
+#define STPMIC_RETAIN_SYNC(ctx)     __stpmic_retain_sync(ctx)
+#define STPMIC_RETAIN_HOLD(ctx)     __stpmic_retain_hold(ctx)
 #else
-    uint8_t ret = STPMIC1.dev->write_i2c(
-        STPMIC1.dev, (STPMIC1.addr << 1) | 0, 
-        &reg, sizeof(reg), STPMIC1.timeout_r);
+#define STPMIC_RETAIN_SYNC(ctx)
+#define STPMIC_RETAIN_HOLD(ctx)
+#endif
 
-    if (ret != sizeof(reg)) {
-        return STPMIC_RET_TIMEOUT;
+/* set and clear bits of a cached `INT_MASK_Rx`, an unknown value stays unknown and is not restored. */
+static void __stpmic_cache_mask(stpmic_ctx_t* ctx, uint8_t reg, stpmic_reg_t set, stpmic_reg_t clr) {
+    const uint8_t slot = STPMIC_SLOT(reg);
+
+    if (!STPMIC_SLOT_TEST(ctx->valid, slot)) {
+        STPMIC_SLOT_CLR(ctx->owned, slot);
+        return;
     }
 
-    // --> then, receive register values.
-    ret = STPMIC1.dev->read_i2c(
-        STPMIC1.dev, (STPMIC1.addr << 1) | 1, 
-        &val, sizeof(val), STPMIC1.timeout_r);
+    ctx->cache[slot] = (stpmic_reg_t)((ctx->cache[slot] | set) & ~clr);
+    STPMIC_SLOT_SET(ctx->owned, slot);
+}
 
-    if (ret != sizeof(val)) {
-        return STPMIC_RET_TIMEOUT;
+/* apply a write to an action register to the cache, with the sequence begun. */
+static void __stpmic_cache_action(stpmic_ctx_t* ctx, uint8_t reg, stpmic_reg_t val) {
+    if (reg >= STPMIC_REG_INT_MASK_SET_R1 && reg <= STPMIC_REG_INT_MASK_SET_R4) {
+        __stpmic_cache_mask(ctx, STPMIC_REG_INT_MASK_R1 + (reg - STPMIC_REG_INT_MASK_SET_R1), val, 0);
     }
-#endif
 
-    if (out) {
-        *out = val;
+    else if (reg >= STPMIC_REG_INT_MASK_CLEAR_R1 && reg <= STPMIC_REG_INT_MASK_CLEAR_R4) {
+        __stpmic_cache_mask(ctx, STPMIC_REG_INT_MASK_R1 + (reg - STPMIC_REG_INT_MASK_CLEAR_R1), 0, val);
     }
 
-    if (reg < STPMIC_REG_CACHE_MAX) {
-        STPMIC1.cache[reg] = val;
+    // --> NVM read command: shadow registers are loaded from the NVM.
+    else if (reg == STPMIC_REG_NVM_CR && (val & 3u) == STPMIC_NVMCMD_READ) {
+        for (uint16_t i = STPMIC_REG_NVM_MAIN_CTRL_SHR; i < STPMIC_REG_MAX; ++i) {
+            STPMIC_SLOT_CLR(ctx->valid, STPMIC_SLOT(i));
+        }
     }
-
-    return STPMIC_RET_OK;
 }
 
-/* write a register of STPMIC without cache. */
-stpmic_ret_t stpmic_write_direct(stpmic_regid_t reg, stpmic_reg_t val) {
-    if (STPMIC1.state < STPMIC_DRV_INIT) {
-        return STPMIC_RET_NODEV;
-    }
-    
-    if (reg >= STPMIC_REG_MAX) {
-        return STPMIC_RET_INVALID;
-    }
+/* store values to cache, `written`: values are written to the device. */
+static void __stpmic_cache_store(stpmic_ctx_t* ctx, uint8_t reg, const stpmic_reg_t* in, uint8_t len, uint8_t written) {
+    STPMIC_SEQ_BEGIN(ctx);
 
-    uint8_t buf[2] = { reg, val };
-    
-#if STPMIC_USE_HAL
-    HAL_StatusTypeDef ret = HAL_I2C_Master_Transmit(
-        STPMIC1.dev, (STPMIC1.addr << 1) | 0, 
-        buf, sizeof(buf), STPMIC1.timeout_w);
+    for (uint8_t i = 0; i < len; ++i, ++reg) {
+        // --> volatile registers and gaps of bursts.
+        if (!STPMIC_IS_CACHED(reg)) {
+            if (written) {
+                __stpmic_cache_action(ctx, reg, in[i]);
+            }
 
-    if (ret != HAL_OK) {
-        return STPMIC_RET_TIMEOUT;
-    }
-#elif STPMIC_USE_CUSTOM
-    uint8_t ret = stpmic_write_i2c((STPMIC1.addr << 1) | 0, 
-        buf, sizeof(buf), STPMIC1.timeout_w);
+            continue;
+        }
 
-    if (ret != sizeof(buf)) {
-        return STPMIC_RET_TIMEOUT;
-    }
-#else
-    uint8_t ret = STPMIC1.dev->write_i2c(
-        STPMIC1.dev, (STPMIC1.addr << 1) | 0, 
-        buf, sizeof(buf), STPMIC1.timeout_w);
+        uint8_t slot = STPMIC_SLOT(reg);
+        if (written) {
+            STPMIC_SLOT_CLR(ctx->dirty, slot);
 
-    if (ret != sizeof(buf)) {
-        return STPMIC_RET_TIMEOUT;
-    }
+            // --> configured by the firmware, shadow registers follow the NVM.
+            if (!(STPMIC_REGATTR[reg] & (STPMIC_REGATTR_RO | STPMIC_REGATTR_NVM))) {
+                STPMIC_SLOT_SET(ctx->owned, slot);
+#if STPMIC_USE_RECONCILE
+                // --> commands are not desired state, they clear themselves.
+                ctx->rec.want[slot] = (stpmic_reg_t)(in[i] & ~STPMIC_CMD_BITS(reg));
 #endif
+            }
+        }
+
+        // --> pending batch writes take precedence over the device.
+        else if (STPMIC_SLOT_TEST(ctx->dirty, slot)) {
+            continue;
+        }
 
-    if (reg < STPMIC_REG_CACHE_MAX) {
-        STPMIC1.cache[reg] = val;
+        // --> commands are done once written, the register reads back without them.
+        ctx->cache[slot] = (stpmic_reg_t)(in[i] & ~STPMIC_CMD_BITS(reg));
+        STPMIC_SLOT_SET(ctx->valid, slot);
     }
-    
-    return STPMIC_RET_OK;
+
+    STPMIC_SEQ_END(ctx);
+    STPMIC_RETAIN_SYNC(ctx);
 }
 
-/* read a register of STPMIC with cache. */
-stpmic_ret_t stpmic_read(stpmic_regid_t reg, stpmic_reg_t* out) {
-    if (STPMIC1.state < STPMIC_DRV_INIT) {
-        return STPMIC_RET_NODEV;
-    }
-    
-    if (reg >= STPMIC_REG_MAX) {
-        return STPMIC_RET_INVALID;
-    }
+/* test whether the register value is cached and valid or not. */
+static uint8_t __stpmic_cache_hit(stpmic_ctx_t* ctx, uint8_t reg) {
+    return STPMIC_IS_CACHED(reg) &&
+        STPMIC_SLOT_TEST(ctx->valid, STPMIC_SLOT(reg));
+}
 
-    if (reg >= STPMIC_REG_CACHE_MAX || (
-        STPMIC1.cache[reg] & STPMIC_CACHE_MISMATCH)) 
-    {
-        return stpmic_read_direct(reg, out);
-    }
+/* invalidate all register caches. */
+static void __stpmic_cache_invalidate(stpmic_ctx_t* ctx) {
+    STPMIC_SEQ_BEGIN(ctx);
+    memset(ctx->valid, 0, sizeof(ctx->valid));
+    memset(ctx->dirty, 0, sizeof(ctx->dirty));
+    STPMIC_SEQ_END(ctx);
+    STPMIC_RETAIN_SYNC(ctx);
+}
 
-    if (out) {
-    	*out = (uint8_t)(STPMIC1.cache[reg] & 0xffu);
+/* clear caches of registers in `[reg, reg + len)`, the device state of them is unknown. */
+static void __stpmic_cache_drop(stpmic_ctx_t* ctx, uint8_t reg, uint8_t len) {
+    STPMIC_SEQ_BEGIN(ctx);
+
+    for (uint8_t i = 0; i < len; ++i, ++reg) {
+        if (STPMIC_IS_CACHED(reg)) {
+            STPMIC_SLOT_CLR(ctx->valid, STPMIC_SLOT(reg));
+            STPMIC_CLR_DIRTY(ctx, reg);
+        }
     }
 
-    return STPMIC_RET_OK;
+    STPMIC_SEQ_END(ctx);
+    STPMIC_RETAIN_SYNC(ctx);
 }
 
-/* write a register of STPMIC with cache. */
-stpmic_ret_t stpmic_write(stpmic_regid_t reg, stpmic_reg_t val) {
-    if (STPMIC1.state < STPMIC_DRV_INIT) {
-        return STPMIC_RET_NODEV;
-    }
-    
-    if (reg >= STPMIC_REG_MAX) {
-        return STPMIC_RET_INVALID;
+/* read a cached register without the lock, returns 0 if not cached or raced with writers. */
+static uint8_t __stpmic_cache_read(stpmic_ctx_t* ctx, uint8_t reg, stpmic_reg_t* out) {
+    if (!STPMIC_IS_CACHED(reg)) {
+        return 0;
     }
 
-    if (reg >= STPMIC_REG_CACHE_MAX || (
-        STPMIC1.cache[reg] & STPMIC_CACHE_MISMATCH)) 
-    {
-        return stpmic_write_direct(reg, val);
+    uint8_t slot = STPMIC_SLOT(reg);
+
+#if STPMIC_USE_LOCK
+    // --> a preempted writer never completes while this spins, so retries are bounded.
+    for (uint8_t i = 0; i < STPMIC_SEQ_RETRY; ++i) {
+        uint32_t seq = ctx->seq;
+        STPMIC_BARRIER();
+
+        // --> the valid bit and the value are in different bytes, both under the sequence.
+        uint8_t valid = STPMIC_SLOT_TEST((volatile uint8_t*) ctx->valid, slot);
+        stpmic_reg_t val = ((volatile stpmic_reg_t*) ctx->cache)[slot];
+        STPMIC_BARRIER();
+
+        if ((seq & 1) || seq != ctx->seq) {
+            continue;
+        }
+
+        if (!valid) {
+            return 0;
+        }
+
+        *out = val;
+        return 1;
     }
 
-    if ((uint8_t)(STPMIC1.cache[reg] & 0xffu) != val) {
-        return stpmic_write_direct(reg, val);
+    return 0;
+#else
+    if (!STPMIC_SLOT_TEST(ctx->valid, slot)) {
+        return 0;
     }
 
-    return STPMIC_RET_OK;
+    *out = ctx->cache[slot];
+    return 1;
+#endif
 }
 
-/* clear a register cache. */
-stpmic_ret_t stpmic_clear_cache(stpmic_regid_t reg) {
-    if (STPMIC1.state < STPMIC_DRV_INIT) {
-        return STPMIC_RET_NODEV;
-    }
-    
-    if (reg >= STPMIC_REG_MAX) {
-        return STPMIC_RET_INVALID;
+/* get attributes of a register. */
+uint8_t stpmic_reg_attr(stpmic_regid_t reg) {
+    return reg < STPMIC_REG_MAX ? STPMIC_REGATTR[reg] : STPMIC_REGATTR_NONE;
+}
+
+/* set timeout of STPMIC driver. */
+void stpmic_ctx_set_timeout(stpmic_ctx_t* ctx, stpmic_timeout_t* in) {
+    if (!in) {
+        return;
     }
 
-    STPMIC1.cache[reg] |= STPMIC_CACHE_MISMATCH;
-    return STPMIC_RET_OK;
+    ctx->timeout_w = in->write;
+    ctx->timeout_r = in->read;
 }
 
-/* reserve to write a register of STPMIC. */
-stpmic_ret_t stpmic_batch_write(stpmic_regid_t reg, stpmic_reg_t val) {
-    if (STPMIC1.state < STPMIC_DRV_INIT) {
-        return STPMIC_RET_NODEV;
-    }
-    
-    if (reg >= STPMIC_REG_MAX) {
-        return STPMIC_RET_INVALID;
+void stpmic_ctx_get_timeout(stpmic_ctx_t* ctx, stpmic_timeout_t* out) {
+    if (out) {
+        out->write = ctx->timeout_w;
+        out->read = ctx->timeout_r;
     }
+}
 
-    STPMIC1.cache[reg] = ((uint16_t) val) | STPMIC_CACHE_MISMATCH;
-    return STPMIC_RET_OK;
+/* get a monotonic tick in milliseconds, returns 0 if no tick source is available. */
+static uint8_t __stpmic_tick(stpmic_ctx_t* ctx, uint32_t* out) {
+#if STPMIC_USE_HAL
+    (void) ctx;
+    *out = HAL_GetTick();
+    return 1;
+#elif STPMIC_USE_LINUX
+    struct timespec ts;
+
+    (void) ctx;
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0) {
+        return 0;
+    }
+
+    *out = (uint32_t)(ts.tv_sec * 1000u + ts.tv_nsec / 1000000);
+    return 1;
+#elif STPMIC_USE_CUSTOM && STPMIC_CUSTOM_TICK
+    (void) ctx;
+    *out = stpmic_get_tick_ms();
+    return 1;
+#elif STPMIC_USE_CHAN
+    if (!ctx->dev || !ctx->dev->get_tick) {
+        return 0;
+    }
+
+    *out = ctx->dev->get_tick(ctx->dev);
+    return 1;
+#else
+    (void) ctx;
+    (void) out;
+    return 0;
+#endif
 }
 
-/* flush all pending batch writes. */
-stpmic_ret_t stpmic_batch_flush() {
-    if (STPMIC1.state < STPMIC_DRV_INIT) {
-        return STPMIC_RET_NODEV;
-    }
-    
-    stpmic_ret_t ret = STPMIC_RET_OK;
-    uint32_t total = 0;
-    uint32_t success = 0;
-    
-    for (size_t i = 0;; i += 2) {
-        uint8_t s = STPMIC_REGMAP[i + 0];
-        uint8_t e = STPMIC_REGMAP[i + 1];
+/* update the remaining budget of the deadline, returns 0 if exhausted. */
+static uint32_t __stpmic_deadline_left(stpmic_ctx_t* ctx) {
+    uint32_t now = 0;
 
-        if (s == e && e == 0) {
-            break;
+    if (!ctx->deadline.expired && __stpmic_tick(ctx, &now)) {
+        uint32_t elapsed = now - ctx->deadline.start;
+
+        ctx->deadline.progress.elapsed = elapsed;
+        if (elapsed < ctx->deadline.budget) {
+            return ctx->deadline.left = ctx->deadline.budget - elapsed;
         }
+    }
 
-        while (s < e) {
-            const stpmic_regid_t reg = (stpmic_regid_t) s++;
-            total++;
+    ctx->deadline.expired = 1;
+    return ctx->deadline.left = 0;
+}
 
-            // --> write registers to make cache.
-            ret = stpmic_write_direct(reg, STPMIC1.cache[reg]);
+#if !STPMIC_USE_LINUX
+/* shorten the timeout of a transfer to the remaining budget. */
+static uint32_t __stpmic_timeout(stpmic_ctx_t* ctx, uint32_t timeout) {
+    if (ctx->deadline.active && ctx->deadline.left < timeout) {
+        return ctx->deadline.left;
+    }
 
-            if (ret != STPMIC_RET_OK) {
-                break;
-            }
+    return timeout;
+}
+#endif
 
-            success++;
-        }
+#if STPMIC_USE_LOCK
+/* set lock hooks of STPMIC driver. */
+void stpmic_ctx_set_lock(stpmic_ctx_t* ctx, const stpmic_lock_t* in) {
+    if (in) {
+        ctx->lock = *in;
     }
 
-    if (success >= total) {
-        return STPMIC_RET_OK;
+    else {
+        memset(&ctx->lock, 0, sizeof(ctx->lock));
     }
-
-    // --> return the last error.
-    return ret;
 }
 
-/* reload all cached registers. */
-stpmic_ret_t stpmic_reload_cache() {
-    if (STPMIC1.state < STPMIC_DRV_INIT) {
-        return STPMIC_RET_NODEV;
+/* take the lock. */
+void stpmic_ctx_lock(stpmic_ctx_t* ctx) {
+    if (ctx->lock.lock) {
+        ctx->lock.lock(ctx->lock.arg);
     }
-    
-    stpmic_ret_t ret = STPMIC_RET_OK;
-    uint32_t total = 0;
-    uint32_t success = 0;
-    
-    for (size_t i = 0;; i += 2) {
-        uint8_t s = STPMIC_REGMAP[i + 0];
-        uint8_t e = STPMIC_REGMAP[i + 1];
+}
 
-        if (s == e && e == 0) {
-            break;
-        }
+/* release the lock. */
+void stpmic_ctx_unlock(stpmic_ctx_t* ctx) {
+    if (ctx->lock.unlock) {
+        ctx->lock.unlock(ctx->lock.arg);
+    }
+}
+#endif
 
-        while (s < e) {
-            const stpmic_regid_t reg = (stpmic_regid_t) s++;
-            total++;
+#if STPMIC_USE_RETAIN
+/* set the retained image of the cache. */
+stpmic_ret_t stpmic_ctx_set_retain(stpmic_ctx_t* ctx, stpmic_retain_t* area, uint32_t gen) {
+    if (ctx->state != STPMIC_DRV_NOT_INIT) {
+        return STPMIC_RET_ALREADY;
+    }
 
-            // --> read registers to make cache.
-            ret = stpmic_read_direct(reg, NULL);
+    ctx->retain = area;
+    ctx->gen = gen;
+    return STPMIC_RET_OK;
+}
 
-            if (ret != STPMIC_RET_OK) {
-                break;
-            }
+/* restore the cache from the retained image, returns 1 if the device still matches it. */
+static uint8_t __stpmic_retain_load(stpmic_ctx_t* ctx) {
+    stpmic_retain_t* area = ctx->retain;
+    stpmic_reg_t buf[STPMIC_PROBE_LEN];
 
-            success++;
-        }
+    if (!area || area->magic != STPMIC_RETAIN_MAGIC || area->gen != ctx->gen ||
+        area->addr != (uint8_t) ctx->addr || area->crc != __stpmic_retain_crc(area))
+    {
+        return 0;
     }
 
-    if (success >= total) {
-        return STPMIC_RET_OK;
+    // --> not supported MAJOR version, or not known.
+    uint8_t version = STPMIC_SLOT(STPMIC_REG_VERSION_SR);
+    if (!STPMIC_SLOT_TEST(area->valid, version) ||
+        (area->cache[version] & 0xf0) != (STPMIC1_MAJOR_VER << 4))
+    {
+        return 0;
     }
 
-    // --> return the last error.
-    return ret;
-}
+    memcpy(ctx->cache, area->cache, sizeof(ctx->cache));
+    memcpy(ctx->valid, area->valid, sizeof(ctx->valid));
+    memset(ctx->dirty, 0, sizeof(ctx->dirty));
+    STPMIC_RETAIN_STRIP(ctx->cache);
 
-/* get the version of STPMIC. */
-stpmic_ret_t stpmic_version(stpmic_version_t* out) {
-    stpmic_reg_t version_sr;
-    stpmic_ret_t ret = stpmic_read(STPMIC_REG_VERSION_SR, &version_sr);
+    // --> detached while probing, the probe stores read values to the cache.
+    ctx->retain = NULL;
+    stpmic_ret_t ret = stpmic_ctx_read_burst(ctx, STPMIC_PROBE_REG, buf, STPMIC_PROBE_LEN);
+    ctx->retain = area;
 
     if (ret != STPMIC_RET_OK) {
-        return ret;
+        return 0;
     }
 
-    if (out) {
-        out->major = (version_sr >> 4) & 0x0fu;
-        out->minor = (version_sr >> 0) & 0x0fu;
-    }
+    for (uint8_t i = 0; i < STPMIC_PROBE_LEN; ++i) {
+        uint8_t slot = STPMIC_SLOT(STPMIC_PROBE_REG + i);
 
-    return STPMIC_RET_OK;
-}
+        if (STPMIC_SLOT_TEST(area->valid, slot) && area->cache[slot] != buf[i]) {
+            return 0;
+        }
+    }
 
-/* get the STPMIC's operating mode. */
-uint8_t stpmic_opmode_is_main() {
-    stpmic_reg_t reg;
+    // --> registers to re-apply after a restart, and the reference of restart checks.
+    memcpy(ctx->owned, area->owned, sizeof(ctx->owned));
+    memcpy(ctx->status, area->status, sizeof(ctx->status));
+    ctx->status_known = area->status_known;
 
-    if (stpmic_restartsr(&reg) != STPMIC_RET_OK) {
-        return 0xffu;
+#if STPMIC_USE_RECONCILE
+    // --> owned registers hold the last written values.
+    for (uint8_t i = 0; i < STPMIC_CACHE_SLOTS; ++i) {
+        if (STPMIC_SLOT_TEST(ctx->owned, i)) {
+            ctx->rec.want[i] = ctx->cache[i];
+        }
     }
+#endif
 
-    return reg & STPMIC_RESTARTSR_OP_MODE_MASK;
+    __stpmic_retain_sync(ctx);
+    return 1;
+}
+#endif
+
+#if STPMIC_USE_CUSTOM
+/* initialize the STPMIC driver. */
+stpmic_ret_t stpmic_ctx_init(stpmic_ctx_t* ctx, int16_t addr) {
+    if (!ctx || addr > 0x7f) {
+        return STPMIC_RET_INVALID;
+    }
+#else
+/* initialize the STPMIC driver. */
+stpmic_ret_t stpmic_ctx_init(stpmic_ctx_t* ctx, stpmic_i2c_t* dev, int16_t addr) {
+    if (!ctx || !dev || addr > 0x7f) {
+        return STPMIC_RET_INVALID;
+    }
+#endif
+    if (ctx->state != STPMIC_DRV_NOT_INIT) {
+        return STPMIC_RET_ALREADY;
+    }
+
+#if STPMIC_USE_CHAN
+    if (!dev->read_i2c || !dev->write_i2c) {
+        return STPMIC_RET_NOTSUP;
+    }
+#elif STPMIC_USE_LINUX
+    if (dev->fd < 0) {
+        return STPMIC_RET_INVALID;
+    }
+#endif
+
+    if (addr < 0) {
+        addr = STPMIC1_DEF_ADDR;
+    }
+
+    // --> zero-initialized context: use initial delay settings.
+    if (!ctx->timeout_r && !ctx->timeout_w) {
+        ctx->timeout_r = STPMIC_INIT_DELAY;
+        ctx->timeout_w = STPMIC_INIT_DELAY;
+    }
+
+    uint8_t version_sr;
+    stpmic_ret_t ret;
+
+#if !STPMIC_USE_CUSTOM
+    ctx->dev = dev;
+#endif
+    ctx->addr = addr;
+    ctx->state = STPMIC_DRV_INIT;
+
+#if STPMIC_USE_RETAIN
+    // --> warm start: the device kept running while the MCU was reset.
+    if ((ctx->warm = __stpmic_retain_load(ctx)) != 0) {
+        ctx->state = STPMIC_DRV_READY;
+        return STPMIC_RET_OK;
+    }
+#endif
+
+    __stpmic_cache_invalidate(ctx);
+    
+    // --> read VERSION_SR register.
+    ret = stpmic_ctx_read_direct(ctx, STPMIC_REG_VERSION_SR, &version_sr);
+
+    // --> failed to read.
+    if (ret != STPMIC_RET_OK) {
+        ctx->state = STPMIC_DRV_NOT_INIT;
+        return ret;
+    }
+
+    // --> not supported MAJOR version.
+    if ((version_sr & 0xf0) != (STPMIC1_MAJOR_VER << 4)) {
+        ctx->state = STPMIC_DRV_NOT_INIT;
+        return STPMIC_RET_NOTSUP;
+    }
+
+#if !STPMIC_LAZY_INIT
+    // --> make register caches, lazy init fills them on first access.
+    if (stpmic_ctx_reload_cache(ctx) != STPMIC_RET_OK) {
+        ctx->state = STPMIC_DRV_NOT_INIT;
+        return STPMIC_RET_UNKNOWN;
+    }
+#endif
+    
+    ctx->state = STPMIC_DRV_READY;
+    return STPMIC_RET_OK;
+}
+
+/* de-initialize the STPMIC driver. */
+stpmic_ret_t stpmic_ctx_deinit(stpmic_ctx_t* ctx) {
+    if (ctx->state == STPMIC_DRV_NOT_INIT) {
+        return STPMIC_RET_NODEV;
+    }
+
+    STPMIC_LOCK(ctx);
+
+#if STPMIC_USE_ASYNC
+    if (ctx->async.busy) {
+        STPMIC_UNLOCK(ctx);
+        return STPMIC_RET_BUSY;
+    }
+#endif
+
+#if !STPMIC_USE_CUSTOM
+    ctx->dev = NULL;
+#endif
+    ctx->addr = -1;
+    ctx->state = STPMIC_DRV_NOT_INIT;
+
+    STPMIC_SEQ_BEGIN(ctx);
+    memset(ctx->cache, 0, sizeof(ctx->cache));
+    memset(ctx->valid, 0, sizeof(ctx->valid));
+    memset(ctx->dirty, 0, sizeof(ctx->dirty));
+    STPMIC_SEQ_END(ctx);
+
+    memset(ctx->owned, 0, sizeof(ctx->owned));
+    ctx->status_known = 0;
+    ctx->restarts = 0;
+
+#if STPMIC_USE_RETAIN
+    // --> the device is not tracked anymore.
+    __stpmic_retain_hold(ctx);
+    ctx->retain = NULL;
+    ctx->warm = 0;
+#endif
+
+#if STPMIC_USE_RECONCILE
+    memset(&ctx->rec, 0, sizeof(ctx->rec));
+#endif
+
+#if STPMIC_EVLOG_SIZE
+    memset(&ctx->evlog, 0, sizeof(ctx->evlog));
+#endif
+
+#if STPMIC_USE_OCP_POLICY
+    memset(&ctx->ocp, 0, sizeof(ctx->ocp));
+#endif
+
+#if STPMIC_IRQ_RING
+    // --> drop notifications, `head` belongs to the interrupt handler.
+    ctx->irq.tail = ctx->irq.head;
+#endif
+
+    ctx->skips = 0;
+    ctx->hits = 0;
+    ctx->misses = 0;
+    ctx->ahead = 0;
+    STPMIC_UNLOCK(ctx);
+    return STPMIC_RET_OK;
+}
+
+#if STPMIC_USE_LINUX
+/* transfer spans using `I2C_RDWR`, all spans in a single ioctl. */
+static stpmic_ret_t __stpmic_linux_rdwr(stpmic_ctx_t* ctx, const stpmic_span_t* spans, uint8_t n, uint8_t write) {
+    struct i2c_msg msgs[2 * STPMIC_SPAN_MAX];
+    struct i2c_rdwr_ioctl_data data;
+    uint8_t regs[STPMIC_SPAN_MAX];
+    uint8_t bufs[STPMIC_SPAN_MAX][1 + STPMIC_BURST_MAX];
+    uint32_t count = 0;
+
+    for (uint8_t i = 0; i < n; ++i) {
+        if (write) {
+            // --> (register address) + (values...), address auto-increments.
+            bufs[i][0] = spans[i].reg;
+            memcpy(&bufs[i][1], spans[i].buf, spans[i].len);
+
+            msgs[count].addr = ctx->addr;
+            msgs[count].flags = 0;
+            msgs[count].len = spans[i].len + 1;
+            msgs[count++].buf = bufs[i];
+            continue;
+        }
+
+        // --> write the address, then read values after repeated-start.
+        regs[i] = spans[i].reg;
+        msgs[count].addr = ctx->addr;
+        msgs[count].flags = 0;
+        msgs[count].len = 1;
+        msgs[count++].buf = &regs[i];
+
+        msgs[count].addr = ctx->addr;
+        msgs[count].flags = I2C_M_RD;
+        msgs[count].len = spans[i].len;
+        msgs[count++].buf = spans[i].buf;
+    }
+
+    data.msgs = msgs;
+    data.nmsgs = count;
+
+    if (ioctl(ctx->dev->fd, I2C_RDWR, &data) != (int) count) {
+        return STPMIC_RET_TIMEOUT;
+    }
+
+    return STPMIC_RET_OK;
+}
+
+/* transfer a span using SMBus I2C block transfer, for SMBus-only adapters. */
+static stpmic_ret_t __stpmic_linux_smbus(stpmic_ctx_t* ctx, const stpmic_span_t* span, uint8_t write) {
+    union i2c_smbus_data data;
+    struct i2c_smbus_ioctl_data args;
+
+    if (ctx->dev->slave != ctx->addr) {
+        if (ioctl(ctx->dev->fd, I2C_SLAVE, ctx->addr) < 0) {
+            return STPMIC_RET_NODEV;
+        }
+
+        ctx->dev->slave = ctx->addr;
+    }
+
+    data.block[0] = span->len;
+    if (write) {
+        memcpy(&data.block[1], span->buf, span->len);
+    }
+
+    args.read_write = write ? I2C_SMBUS_WRITE : I2C_SMBUS_READ;
+    args.command = span->reg;
+    args.size = I2C_SMBUS_I2C_BLOCK_DATA;
+    args.data = &data;
+
+    if (ioctl(ctx->dev->fd, I2C_SMBUS, &args) < 0) {
+        return STPMIC_RET_TIMEOUT;
+    }
+
+    if (!write) {
+        if (data.block[0] != span->len) {
+            return STPMIC_RET_TIMEOUT;
+        }
+
+        memcpy(span->buf, &data.block[1], span->len);
+    }
+
+    return STPMIC_RET_OK;
+}
+#else
+/* read a span of registers by a single auto-increment transfer. */
+static stpmic_ret_t __stpmic_read_span(stpmic_ctx_t* ctx, const stpmic_span_t* span) {
+    uint8_t reg = span->reg;
+    uint8_t len = span->len;
+    stpmic_reg_t* out = span->buf;
+    uint32_t timeout = __stpmic_timeout(ctx, ctx->timeout_r);
+
+#if STPMIC_USE_HAL
+    // --> write the address, then read values after repeated-start.
+    HAL_StatusTypeDef ret = HAL_I2C_Mem_Read(
+        ctx->dev, (ctx->addr << 1) | 0, reg, I2C_MEMADD_SIZE_8BIT,
+        out, len, timeout);
+
+    if (ret != HAL_OK) {
+        return STPMIC_RET_TIMEOUT;
+    }
+#elif STPMIC_USE_CUSTOM && STPMIC_CUSTOM_COMBINED
+    // --> write the address, then read values after repeated-start.
+    uint8_t ret = stpmic_read_reg_i2c((ctx->addr << 1) | 0, 
+        reg, out, len, timeout);
+
+    if (ret != len) {
+        return STPMIC_RET_TIMEOUT;
+    }
+#elif STPMIC_USE_CUSTOM
+    uint8_t ret = stpmic_write_i2c((ctx->addr << 1) | 0, 
+        &reg, sizeof(reg), timeout);
+
+    if (ret != sizeof(reg)) {
+        return STPMIC_RET_TIMEOUT;
+    }
+
+    // --> then, receive register values, address auto-increments.
+    ret = stpmic_read_i2c((ctx->addr << 1) | 1, 
+        out, len, timeout);
+
+    if (ret != len) {
+        return STPMIC_RET_TIMEOUT;
+    }
+#else
+    uint8_t ret;
+
+    // --> write the address, then read values after repeated-start.
+    if (ctx->dev->read_reg_i2c) {
+        ret = ctx->dev->read_reg_i2c(
+            ctx->dev, (ctx->addr << 1) | 0, 
+            reg, out, len, timeout);
+
+        if (ret != len) {
+            return STPMIC_RET_TIMEOUT;
+        }
+    }
+
+    else {
+        ret = ctx->dev->write_i2c(
+            ctx->dev, (ctx->addr << 1) | 0, 
+            &reg, sizeof(reg), timeout);
+
+        if (ret != sizeof(reg)) {
+            return STPMIC_RET_TIMEOUT;
+        }
+
+        // --> then, receive register values, address auto-increments.
+        ret = ctx->dev->read_i2c(
+            ctx->dev, (ctx->addr << 1) | 1, 
+            out, len, timeout);
+
+        if (ret != len) {
+            return STPMIC_RET_TIMEOUT;
+        }
+    }
+#endif
+
+    return STPMIC_RET_OK;
+}
+
+/* write a span of registers by a single auto-increment transfer. */
+static stpmic_ret_t __stpmic_write_span(stpmic_ctx_t* ctx, const stpmic_span_t* span) {
+    uint8_t buf[1 + STPMIC_BURST_MAX];
+    uint8_t n = span->len;
+    uint32_t timeout = __stpmic_timeout(ctx, ctx->timeout_w);
+
+    // --> (register address) + (values...), address auto-increments.
+    buf[0] = span->reg;
+    memcpy(&buf[1], span->buf, n);
+
+#if STPMIC_USE_HAL
+    HAL_StatusTypeDef ret = HAL_I2C_Master_Transmit(
+        ctx->dev, (ctx->addr << 1) | 0, 
+        buf, n + 1, timeout);
+
+    if (ret != HAL_OK) {
+        return STPMIC_RET_TIMEOUT;
+    }
+#elif STPMIC_USE_CUSTOM
+    uint8_t ret = stpmic_write_i2c((ctx->addr << 1) | 0, 
+        buf, n + 1, timeout);
+
+    if (ret != n + 1) {
+        return STPMIC_RET_TIMEOUT;
+    }
+#else
+    uint8_t ret = ctx->dev->write_i2c(
+        ctx->dev, (ctx->addr << 1) | 0, 
+        buf, n + 1, timeout);
+
+    if (ret != n + 1) {
+        return STPMIC_RET_TIMEOUT;
+    }
+#endif
+
+    return STPMIC_RET_OK;
+}
+#endif
+
+/* account completed spans to the progress of the deadline. */
+static void __stpmic_progress(stpmic_ctx_t* ctx, const stpmic_span_t* spans, uint8_t n) {
+    if (!ctx->deadline.active) {
+        return;
+    }
+
+    for (uint8_t i = 0; i < n; ++i) {
+        ctx->deadline.progress.xfers++;
+        ctx->deadline.progress.regs += spans[i].len;
+    }
+}
+
+/* transfer spans of registers, `done`: count of completed spans. */
+static stpmic_ret_t __stpmic_xfer(stpmic_ctx_t* ctx, const stpmic_span_t* spans, uint8_t n, uint8_t write, uint8_t* done) {
+    stpmic_ret_t ret = STPMIC_RET_OK;
+
+    // --> synced again when completed spans are stored to the cache.
+    if (write) {
+        STPMIC_RETAIN_HOLD(ctx);
+    }
+
+#if STPMIC_USE_LINUX
+    // --> pack all spans into a single ioctl.
+    if (ctx->dev->funcs & I2C_FUNC_I2C) {
+        *done = 0;
+
+        if (ctx->deadline.active && !__stpmic_deadline_left(ctx)) {
+            return STPMIC_RET_DEADLINE;
+        }
+
+        if ((ret = __stpmic_linux_rdwr(ctx, spans, n, write)) == STPMIC_RET_OK) {
+            *done = n;
+        }
+
+        __stpmic_progress(ctx, spans, *done);
+        return ret;
+    }
+#endif
+
+    for (*done = 0; *done < n; (*done)++) {
+        // --> stop issuing transfers once the budget is exhausted.
+        if (ctx->deadline.active && !__stpmic_deadline_left(ctx)) {
+            ret = STPMIC_RET_DEADLINE;
+            break;
+        }
+
+#if STPMIC_USE_LINUX
+        ret = __stpmic_linux_smbus(ctx, &spans[*done], write);
+#else
+        ret = write
+            ? __stpmic_write_span(ctx, &spans[*done])
+            : __stpmic_read_span(ctx, &spans[*done]);
+#endif
+
+        if (ret != STPMIC_RET_OK) {
+            break;
+        }
+
+        __stpmic_progress(ctx, &spans[*done], 1);
+    }
+
+    return ret;
+}
+
+/* transfer spans of registers, then store completed spans to cache. */
+static stpmic_ret_t __stpmic_xfer_cached(stpmic_ctx_t* ctx, const stpmic_span_t* spans, uint8_t n, uint8_t write) {
+    uint8_t done = 0;
+    stpmic_ret_t ret;
+
+    STPMIC_LOCK(ctx);
+
+#if STPMIC_USE_ASYNC
+    // --> tested again with the lock held.
+    if (ctx->async.busy) {
+        STPMIC_UNLOCK(ctx);
+        return STPMIC_RET_BUSY;
+    }
+#endif
+
+    ret = __stpmic_xfer(ctx, spans, n, write, &done);
+    for (uint8_t i = 0; i < done; ++i) {
+        __stpmic_cache_store(ctx, spans[i].reg, spans[i].buf, spans[i].len, write);
+    }
+
+    STPMIC_UNLOCK(ctx);
+    return ret;
+}
+
+/* write a command to a register without the cache, it must not be re-applied. */
+static stpmic_ret_t __stpmic_xfer_command(stpmic_ctx_t* ctx, uint8_t reg, stpmic_reg_t val) {
+    stpmic_span_t span = { reg, 1, &val };
+    uint8_t done = 0;
+    stpmic_ret_t ret;
+
+    STPMIC_LOCK(ctx);
+
+#if STPMIC_USE_ASYNC
+    if (ctx->async.busy) {
+        STPMIC_UNLOCK(ctx);
+        return STPMIC_RET_BUSY;
+    }
+#endif
+
+    ret = __stpmic_xfer(ctx, &span, 1, 1, &done);
+    STPMIC_UNLOCK(ctx);
+    return ret;
+}
+
+#if STPMIC_USE_LINUX
+/* open `/dev/i2c-N` device for STPMIC driver. */
+stpmic_ret_t stpmic_linux_open(stpmic_i2c_t* dev, const char* path) {
+    unsigned long funcs = 0;
+
+    if (!dev || !path) {
+        return STPMIC_RET_INVALID;
+    }
+
+    dev->fd = -1;
+    dev->funcs = 0;
+    dev->slave = -1;
+
+    int fd = open(path, O_RDWR);
+    if (fd < 0) {
+        return STPMIC_RET_NODEV;
+    }
+
+    if (ioctl(fd, I2C_FUNCS, &funcs) < 0) {
+        close(fd);
+        return STPMIC_RET_NODEV;
+    }
+
+    if ((funcs & (I2C_FUNC_I2C | I2C_FUNC_SMBUS_I2C_BLOCK)) == 0) {
+        close(fd);
+        return STPMIC_RET_NOTSUP;
+    }
+
+    dev->fd = fd;
+    dev->funcs = (uint32_t) funcs;
+    return STPMIC_RET_OK;
+}
+
+/* close `/dev/i2c-N` device. */
+void stpmic_linux_close(stpmic_i2c_t* dev) {
+    if (dev && dev->fd >= 0) {
+        close(dev->fd);
+        dev->fd = -1;
+    }
+}
+#endif
+
+/* read a register of STPMIC without cache. */
+stpmic_ret_t stpmic_ctx_read_direct(stpmic_ctx_t* ctx, stpmic_regid_t reg, stpmic_reg_t* out) {
+    stpmic_reg_t val = 0;
+    stpmic_ret_t ret = stpmic_ctx_read_burst(ctx, reg, &val, 1);
+
+    if (ret != STPMIC_RET_OK) {
+        return ret;
+    }
+
+    if (out) {
+        *out = val;
+    }
+
+    return STPMIC_RET_OK;
+}
+
+/* read contiguous registers of STPMIC using auto-increment, without cache. */
+stpmic_ret_t stpmic_ctx_read_burst(stpmic_ctx_t* ctx, stpmic_regid_t reg, stpmic_reg_t* out, uint8_t len) {
+    if (ctx->state < STPMIC_DRV_INIT) {
+        return STPMIC_RET_NODEV;
+    }
+
+#if STPMIC_USE_ASYNC
+    // --> an asynchronous operation owns the bus.
+    if (ctx->async.busy) {
+        return STPMIC_RET_BUSY;
+    }
+#endif
+    
+    if (!out || !len || ((uint32_t)reg) + len > STPMIC_REG_MAX) {
+        return STPMIC_RET_INVALID;
+    }
+
+    stpmic_span_t span = { .reg = reg, .len = len, .buf = out };
+    return __stpmic_xfer_cached(ctx, &span, 1, 0);
+}
+
+/* write a register of STPMIC without cache. */
+stpmic_ret_t stpmic_ctx_write_direct(stpmic_ctx_t* ctx, stpmic_regid_t reg, stpmic_reg_t val) {
+    return stpmic_ctx_write_burst(ctx, reg, &val, 1);
+}
+
+/* write contiguous registers of STPMIC using auto-increment, without cache. */
+stpmic_ret_t stpmic_ctx_write_burst(stpmic_ctx_t* ctx, stpmic_regid_t reg, const stpmic_reg_t* in, uint8_t len) {
+    if (ctx->state < STPMIC_DRV_INIT) {
+        return STPMIC_RET_NODEV;
+    }
+
+#if STPMIC_USE_ASYNC
+    // --> an asynchronous operation owns the bus.
+    if (ctx->async.busy) {
+        return STPMIC_RET_BUSY;
+    }
+#endif
+    
+    if (!in || !len || ((uint32_t)reg) + len > STPMIC_REG_MAX) {
+        return STPMIC_RET_INVALID;
+    }
+
+    stpmic_span_t spans[STPMIC_SPAN_MAX];
+    uint8_t n = 0;
+
+    // --> split into bursts, 255 bytes fit in `STPMIC_SPAN_MAX` spans.
+    for (uint32_t i = 0; i < len; i += STPMIC_BURST_MAX, ++n) {
+        spans[n].reg = (uint8_t)(reg + i);
+        spans[n].len = (uint8_t)(len - i > STPMIC_BURST_MAX ? STPMIC_BURST_MAX : len - i);
+        spans[n].buf = (stpmic_reg_t*)(in + i);
+    }
+
+    return __stpmic_xfer_cached(ctx, spans, n, 1);
+}
+
+#if STPMIC_READ_AHEAD >= STPMIC_BURST_MAX
+#error "STPMIC_READ_AHEAD should be less than STPMIC_BURST_MAX."
+#endif
+
+/* read a missed register with uncached registers after it in the same burst, with the lock held. */
+static stpmic_ret_t __stpmic_read_ahead(stpmic_ctx_t* ctx, uint8_t reg, stpmic_reg_t* out) {
+    stpmic_reg_t buf[1 + STPMIC_READ_AHEAD];
+    uint16_t end = reg + 1;
+    uint8_t ahead = 0;
+
+    // --> up to the last one to fill, volatile registers between them are read through.
+    for (uint16_t e = reg + 1; e < STPMIC_REG_MAX && e <= reg + STPMIC_READ_AHEAD; ++e) {
+        if (STPMIC_IS_CACHED(e) && !__stpmic_cache_hit(ctx, (uint8_t) e)) {
+            end = e + 1;
+            ahead++;
+        }
+    }
+
+    stpmic_ret_t ret = stpmic_ctx_read_burst(ctx, (stpmic_regid_t) reg, buf, (uint8_t)(end - reg));
+    if (ret != STPMIC_RET_OK) {
+        return ret;
+    }
+
+    ctx->ahead += ahead;
+    *out = buf[0];
+    return STPMIC_RET_OK;
+}
+
+/* read a register of STPMIC with cache. */
+stpmic_ret_t stpmic_ctx_read(stpmic_ctx_t* ctx, stpmic_regid_t reg, stpmic_reg_t* out) {
+    if (ctx->state < STPMIC_DRV_INIT) {
+        return STPMIC_RET_NODEV;
+    }
+    
+    if (reg >= STPMIC_REG_MAX) {
+        return STPMIC_RET_INVALID;
+    }
+
+    stpmic_reg_t val = 0;
+    stpmic_ret_t ret = STPMIC_RET_OK;
+
+    // --> cache hits don't wait for the lock, the count may lose concurrent ones.
+    if (__stpmic_cache_read(ctx, reg, &val)) {
+        ctx->hits++;
+    }
+
+    else {
+        STPMIC_LOCK(ctx);
+
+        if (__stpmic_cache_hit(ctx, reg)) {
+            val = STPMIC_CACHE_VAL(ctx, reg);
+            ctx->hits++;
+        }
+
+        else if (STPMIC_IS_CACHED(reg)) {
+            ret = __stpmic_read_ahead(ctx, reg, &val);
+            ctx->misses++;
+        }
+
+        else {
+            ret = stpmic_ctx_read_direct(ctx, reg, &val);
+        }
+
+        STPMIC_UNLOCK(ctx);
+    }
+
+    if (ret == STPMIC_RET_OK && out) {
+        *out = val;
+    }
+
+    return ret;
+}
+
+/* write a register of STPMIC with cache. */
+stpmic_ret_t stpmic_ctx_write(stpmic_ctx_t* ctx, stpmic_regid_t reg, stpmic_reg_t val) {
+    if (ctx->state < STPMIC_DRV_INIT) {
+        return STPMIC_RET_NODEV;
+    }
+    
+    if (reg >= STPMIC_REG_MAX) {
+        return STPMIC_RET_INVALID;
+    }
+
+    if (STPMIC_REGATTR[reg] & STPMIC_REGATTR_RO) {
+        return STPMIC_RET_NOTSUP;
+    }
+
+    stpmic_ret_t ret = STPMIC_RET_OK;
+    STPMIC_LOCK(ctx);
+
+    // --> also writes through pending batch writes of the register.
+    if (!__stpmic_cache_hit(ctx, reg) ||
+        STPMIC_CACHE_VAL(ctx, reg) != val || STPMIC_IS_DIRTY(ctx, reg))
+    {
+        ret = stpmic_ctx_write_direct(ctx, reg, val);
+    }
+
+    STPMIC_UNLOCK(ctx);
+    return ret;
+}
+
+/* update bits of a register with the lock held, `changed` is set if the value is changed, nullable. */
+static stpmic_ret_t __stpmic_update_bits_locked(
+    stpmic_ctx_t* ctx, stpmic_regid_t reg,
+    stpmic_reg_t mask, stpmic_reg_t val, uint8_t* changed)
+{
+    stpmic_reg_t org;
+    stpmic_ret_t ret = stpmic_ctx_read(ctx, reg, &org);
+
+    if (ret != STPMIC_RET_OK) {
+        return ret;
+    }
+
+    stpmic_reg_t upd = (org & ~mask) | (val & mask);
+    if (changed) {
+        *changed = upd != org;
+    }
+
+    // --> the device has the value already, pending batch writes are written through.
+    if (upd == org && STPMIC_IS_CACHED(reg) && !STPMIC_IS_DIRTY(ctx, reg)) {
+        ctx->skips++;
+        return STPMIC_RET_OK;
+    }
+
+    return stpmic_ctx_write(ctx, reg, upd);
+}
+
+/* update bits of a register. */
+stpmic_ret_t stpmic_ctx_update_bits(stpmic_ctx_t* ctx, stpmic_regid_t reg, stpmic_reg_t mask, stpmic_reg_t val) {
+    if (ctx->state < STPMIC_DRV_INIT) {
+        return STPMIC_RET_NODEV;
+    }
+    
+    if (reg >= STPMIC_REG_MAX) {
+        return STPMIC_RET_INVALID;
+    }
+
+    if (STPMIC_REGATTR[reg] & STPMIC_REGATTR_RO) {
+        return STPMIC_RET_NOTSUP;
+    }
+
+    STPMIC_LOCK(ctx);
+    stpmic_ret_t ret = __stpmic_update_bits_locked(ctx, reg, mask, val, NULL);
+    STPMIC_UNLOCK(ctx);
+    return ret;
+}
+
+/* stage an update of a register to the transaction with the lock held. */
+static stpmic_ret_t __stpmic_txn_stage(stpmic_ctx_t* ctx, stpmic_regid_t reg, stpmic_reg_t mask, stpmic_reg_t val) {
+    stpmic_reg_t org;
+    uint8_t i = 0;
+
+    // --> the value before the transaction should be known to restore it.
+    if (!STPMIC_IS_CACHED(reg) || (STPMIC_REGATTR[reg] & STPMIC_REGATTR_RO)) {
+        return STPMIC_RET_NOTSUP;
+    }
+
+    while (i < ctx->txn.count && ctx->txn.reg[i] != reg) {
+        i++;
+    }
+
+    if (i < ctx->txn.count) {
+        org = ctx->txn.val[i];
+    }
+
+    else if (i >= STPMIC_TXN_MAX) {
+        return STPMIC_RET_RANGE;
+    }
+
+    else {
+        stpmic_ret_t ret = stpmic_ctx_read(ctx, reg, &org);
+
+        if (ret != STPMIC_RET_OK) {
+            return ret;
+        }
+
+        ctx->txn.count++;
+    }
+
+    ctx->txn.reg[i] = reg;
+    ctx->txn.val[i] = (org & ~mask) | (val & mask);
+    return STPMIC_RET_OK;
+}
+
+/* commit staged writes of the transaction with the lock held. */
+static stpmic_ret_t __stpmic_txn_commit_locked(stpmic_ctx_t* ctx) {
+    stpmic_span_t spans[STPMIC_TXN_MAX];
+    uint8_t regs[STPMIC_TXN_MAX];
+    stpmic_reg_t vals[STPMIC_TXN_MAX];
+    stpmic_reg_t orgs[STPMIC_TXN_MAX];
+    uint8_t m = 0, n = 0, done = 0, undone = 0;
+    stpmic_ret_t ret;
+
+#if STPMIC_USE_ASYNC
+    if (ctx->async.busy) {
+        return STPMIC_RET_BUSY;
+    }
+#endif
+
+    for (uint8_t i = 0; i < ctx->txn.count; ++i) {
+        uint8_t reg = ctx->txn.reg[i];
+        stpmic_reg_t org;
+
+        // --> cleared after staged: read it again before writing anything.
+        if ((ret = stpmic_ctx_read(ctx, (stpmic_regid_t) reg, &org)) != STPMIC_RET_OK) {
+            return ret;
+        }
+
+        if (org == ctx->txn.val[i] && !STPMIC_IS_DIRTY(ctx, reg)) {
+            ctx->skips++;
+            continue;
+        }
+
+        // --> insert in address order.
+        uint8_t j = m++;
+        for (; j > 0 && regs[j - 1] > reg; --j) {
+            regs[j] = regs[j - 1];
+            vals[j] = vals[j - 1];
+            orgs[j] = orgs[j - 1];
+        }
+
+        regs[j] = reg;
+        vals[j] = ctx->txn.val[i];
+        orgs[j] = org;
+    }
+
+    // --> merge adjacent registers into a single burst.
+    for (uint8_t i = 0; i < m; ++i) {
+        if (n > 0 && spans[n - 1].reg + spans[n - 1].len == regs[i]) {
+            spans[n - 1].len++;
+            continue;
+        }
+
+        spans[n].reg = regs[i];
+        spans[n].len = 1;
+        spans[n].buf = &vals[i];
+        n++;
+    }
+
+    ret = __stpmic_xfer(ctx, spans, n, 1, &done);
+    for (uint8_t i = 0; i < done; ++i) {
+        __stpmic_cache_store(ctx, spans[i].reg, spans[i].buf, spans[i].len, 1);
+    }
+
+    if (ret == STPMIC_RET_OK) {
+        return STPMIC_RET_OK;
+    }
+
+    // --> the failed span may be written partially.
+    for (uint8_t i = done; i < n; ++i) {
+        __stpmic_cache_drop(ctx, spans[i].reg, spans[i].len);
+    }
+
+    // --> restore written spans to the values before the transaction, regardless of the deadline.
+    for (uint8_t i = 0; i < done; ++i) {
+        spans[i].buf = &orgs[spans[i].buf - vals];
+    }
+
+    if (done > 0) {
+        uint8_t active = ctx->deadline.active;
+
+        ctx->deadline.active = 0;
+        __stpmic_xfer(ctx, spans, done, 1, &undone);
+        ctx->deadline.active = active;
+    }
+
+    for (uint8_t i = 0; i < done; ++i) {
+        if (i < undone) {
+            __stpmic_cache_store(ctx, spans[i].reg, spans[i].buf, spans[i].len, 1);
+        }
+
+        else {
+            __stpmic_cache_drop(ctx, spans[i].reg, spans[i].len);
+        }
+    }
+
+    return ret;
+}
+
+/* open a transaction with the lock held, returns 1 if opened, 0 if one is active already. */
+static uint8_t __stpmic_txn_open(stpmic_ctx_t* ctx) {
+    if (ctx->txn.active) {
+        return 0;
+    }
+
+    ctx->txn.active = 1;
+    ctx->txn.count = 0;
+    return 1;
+}
+
+/* close the transaction with the lock held, commits if `ret` is `STPMIC_RET_OK`. */
+static stpmic_ret_t __stpmic_txn_close(stpmic_ctx_t* ctx, stpmic_ret_t ret) {
+    if (ret == STPMIC_RET_OK) {
+        ret = __stpmic_txn_commit_locked(ctx);
+    }
+
+    ctx->txn.active = 0;
+    ctx->txn.count = 0;
+    return ret;
+}
+
+/* begin a transaction. */
+stpmic_ret_t stpmic_ctx_txn_begin(stpmic_ctx_t* ctx) {
+    if (ctx->state < STPMIC_DRV_INIT) {
+        return STPMIC_RET_NODEV;
+    }
+
+    // --> released by `stpmic_ctx_txn_commit` or `stpmic_ctx_txn_abort`.
+    STPMIC_LOCK(ctx);
+    if (!__stpmic_txn_open(ctx)) {
+        STPMIC_UNLOCK(ctx);
+        return STPMIC_RET_ALREADY;
+    }
+
+    return STPMIC_RET_OK;
+}
+
+/* stage a write to a register in the transaction. */
+stpmic_ret_t stpmic_ctx_txn_write(stpmic_ctx_t* ctx, stpmic_regid_t reg, stpmic_reg_t val) {
+    return stpmic_ctx_txn_update_bits(ctx, reg, 0xffu, val);
+}
+
+/* stage an update of bits of a register in the transaction. */
+stpmic_ret_t stpmic_ctx_txn_update_bits(stpmic_ctx_t* ctx, stpmic_regid_t reg, stpmic_reg_t mask, stpmic_reg_t val) {
+    if (ctx->state < STPMIC_DRV_INIT) {
+        return STPMIC_RET_NODEV;
+    }
+    
+    if (reg >= STPMIC_REG_MAX) {
+        return STPMIC_RET_INVALID;
+    }
+
+    STPMIC_LOCK(ctx);
+    stpmic_ret_t ret = ctx->txn.active
+        ? __stpmic_txn_stage(ctx, reg, mask, val)
+        : STPMIC_RET_INVALID;
+
+    STPMIC_UNLOCK(ctx);
+    return ret;
+}
+
+/* commit the transaction. */
+stpmic_ret_t stpmic_ctx_txn_commit(stpmic_ctx_t* ctx) {
+    // --> the owner takes the lock again, other threads wait until it ends the transaction.
+    STPMIC_LOCK(ctx);
+    if (!ctx->txn.active) {
+        STPMIC_UNLOCK(ctx);
+        return STPMIC_RET_INVALID;
+    }
+
+    stpmic_ret_t ret = __stpmic_txn_close(ctx, STPMIC_RET_OK);
+
+    // --> this call, then `stpmic_ctx_txn_begin`.
+    STPMIC_UNLOCK(ctx);
+    STPMIC_UNLOCK(ctx);
+    return ret;
+}
+
+/* abort the transaction. */
+stpmic_ret_t stpmic_ctx_txn_abort(stpmic_ctx_t* ctx) {
+    STPMIC_LOCK(ctx);
+    if (!ctx->txn.active) {
+        STPMIC_UNLOCK(ctx);
+        return STPMIC_RET_INVALID;
+    }
+
+    ctx->txn.active = 0;
+    ctx->txn.count = 0;
+
+    STPMIC_UNLOCK(ctx);
+    STPMIC_UNLOCK(ctx);
+    return STPMIC_RET_OK;
+}
+
+#if STPMIC_USE_RECONCILE
+/* test whether the register has the desired state or not, `INT_MASK_Rx` is set by actions. */
+#define STPMIC_IS_OWNED(ctx, reg) \
+    (STPMIC_IS_CACHED(reg) && STPMIC_SLOT_TEST((ctx)->owned, STPMIC_SLOT(reg)) && \
+    !(STPMIC_REGATTR[reg] & STPMIC_REGATTR_RO))
+
+/* estimated bus time of a transfer in microseconds, 9 clocks per byte and 3 for conditions. */
+static int32_t __stpmic_rec_cost(stpmic_ctx_t* ctx, uint8_t bytes) {
+    return (int32_t)(((bytes * 9u + 3u) * 1000000u + ctx->rec.opts.bus_hz - 1) / ctx->rec.opts.bus_hz);
+}
+
+/* maximum credit: a full burst read and its repair write. */
+static int32_t __stpmic_rec_cap(stpmic_ctx_t* ctx) {
+    return __stpmic_rec_cost(ctx, 3 + ctx->rec.opts.burst) 
+         + __stpmic_rec_cost(ctx, 2 + ctx->rec.opts.burst);
+}
+
+/* set up the reconciler. */
+stpmic_ret_t stpmic_ctx_reconcile_setup(stpmic_ctx_t* ctx, const stpmic_reconcile_t* in) {
+    uint32_t now;
+
+    if (ctx->state < STPMIC_DRV_INIT) {
+        return STPMIC_RET_NODEV;
+    }
+
+    if (in && (!in->bus_hz || !in->duty || in->duty > 1000 || 
+        !in->burst || in->burst > STPMIC_BURST_MAX))
+    {
+        return STPMIC_RET_INVALID;
+    }
+
+    if (in && !__stpmic_tick(ctx, &now)) {
+        return STPMIC_RET_NOTSUP;
+    }
+
+    STPMIC_LOCK(ctx);
+    if (in) {
+        ctx->rec.opts = *in;
+        ctx->rec.credit = __stpmic_rec_cap(ctx);
+        ctx->rec.last = now;
+    }
+
+    else {
+        memset(&ctx->rec.opts, 0, sizeof(ctx->rec.opts));
+    }
+
+    STPMIC_UNLOCK(ctx);
+    return STPMIC_RET_OK;
+}
+
+/* `stpmic_ctx_reconcile` with the lock held. */
+static stpmic_ret_t __stpmic_reconcile_locked(stpmic_ctx_t* ctx, uint32_t now) {
+    stpmic_span_t spans[STPMIC_BURST_MAX];
+    stpmic_reg_t buf[STPMIC_BURST_MAX];
+    uint16_t reg = ctx->rec.next, end;
+    uint8_t n = 0, wrap = 0;
+
+#if STPMIC_USE_ASYNC
+    if (ctx->async.busy) {
+        return STPMIC_RET_BUSY;
+    }
+#endif
+
+    // --> refill the credit by the duty cycle: 1 ms of time gives `duty` us of bus time.
+    // --> idle time doesn't accumulate over a burst.
+    int64_t credit = (int64_t) ctx->rec.credit + (int64_t)(now - ctx->rec.last) * ctx->rec.opts.duty;
+    int32_t cap = __stpmic_rec_cap(ctx);
+
+    ctx->rec.credit = credit > cap ? cap : (int32_t) credit;
+    ctx->rec.last = now;
+
+    // --> the next owned register, wraps around once.
+    for (uint16_t i = 0; i < STPMIC_REG_MAX && !STPMIC_IS_OWNED(ctx, reg); ++i) {
+        if (++reg >= STPMIC_REG_MAX) {
+            wrap = 1;
+            reg = 0;
+        }
+    }
+
+    if (!STPMIC_IS_OWNED(ctx, reg)) {
+        return STPMIC_RET_OK;
+    }
+
+    // --> up to the last owned one in the burst, others are read through.
+    end = reg + 1;
+    for (uint16_t e = reg + 1; e < STPMIC_REG_MAX && e < reg + ctx->rec.opts.burst; ++e) {
+        if (STPMIC_IS_OWNED(ctx, e)) {
+            end = e + 1;
+        }
+    }
+
+    int32_t cost = __stpmic_rec_cost(ctx, (uint8_t)(3 + end - reg));
+    if (ctx->rec.credit < cost) {
+        return STPMIC_RET_OK;
+    }
+
+    ctx->rec.credit -= cost;
+    stpmic_ret_t ret = stpmic_ctx_read_burst(ctx, (stpmic_regid_t) reg, buf, (uint8_t)(end - reg));
+    if (ret != STPMIC_RET_OK) {
+        return ret;
+    }
+
+    for (uint16_t r = reg; r < end; ++r) {
+        // --> pending batch writes differ on purpose.
+        if (!STPMIC_IS_OWNED(ctx, r) || STPMIC_IS_DIRTY(ctx, r)) {
+            continue;
+        }
+
+        stpmic_reg_t* want = &ctx->rec.want[STPMIC_SLOT(r)];
+        if ((stpmic_reg_t)(buf[r - reg] & ~STPMIC_CMD_BITS(r)) == *want) {
+            continue;
+        }
+
+        ctx->rec.drifts++;
+        if (ctx->rec.opts.cb) {
+            ctx->rec.opts.cb((stpmic_regid_t) r, *want, buf[r - reg], ctx->rec.opts.arg);
+        }
+
+        // --> adjacent registers in adjacent slots, write them together.
+        if (n > 0 && spans[n - 1].reg + spans[n - 1].len == r && STPMIC_SLOT_FOLLOWS(r)) {
+            spans[n - 1].len++;
+            continue;
+        }
+
+        spans[n].reg = (uint8_t) r;
+        spans[n].len = 1;
+        spans[n].buf = want;
+        n++;
+    }
+
+    // --> a pass is completed when the walk wraps around.
+    if (wrap || end >= STPMIC_REG_MAX) {
+        ctx->rec.passes++;
+    }
+
+    ctx->rec.next = (uint8_t)(end >= STPMIC_REG_MAX ? 0 : end);
+    for (uint8_t i = 0; i < n; ++i) {
+        ctx->rec.credit -= __stpmic_rec_cost(ctx, 2 + spans[i].len);
+    }
+
+    return n > 0 ? __stpmic_xfer_cached(ctx, spans, n, 1) : STPMIC_RET_OK;
+}
+
+/* compare the next burst of written registers with the device. */
+stpmic_ret_t stpmic_ctx_reconcile(stpmic_ctx_t* ctx) {
+    uint32_t now;
+
+    if (ctx->state < STPMIC_DRV_INIT) {
+        return STPMIC_RET_NODEV;
+    }
+
+    if (!ctx->rec.opts.bus_hz) {
+        return STPMIC_RET_DISABLED;
+    }
+
+    if (!__stpmic_tick(ctx, &now)) {
+        return STPMIC_RET_NOTSUP;
+    }
+
+    STPMIC_LOCK(ctx);
+    stpmic_ret_t ret = __stpmic_reconcile_locked(ctx, now);
+    STPMIC_UNLOCK(ctx);
+    return ret;
+}
+#endif
+
+/* re-apply owned registers after a restart of the device, with the lock held. */
+static stpmic_ret_t __stpmic_restart_apply(stpmic_ctx_t* ctx) {
+    stpmic_span_t spans[STPMIC_SPAN_MAX];
+    stpmic_reg_t masks[8];
+    stpmic_ret_t ret, last = STPMIC_RET_OK;
+    uint8_t n = 0, m = 0, version = STPMIC_SLOT(STPMIC_REG_VERSION_SR);
+
+    // --> interrupt masks are set and cleared as configured: `INT_MASK_SET_Rx`, then `INT_MASK_CLEAR_Rx`.
+    for (uint8_t i = 0; i < 4; ++i) {
+        uint8_t slot = STPMIC_SLOT(STPMIC_REG_INT_MASK_R1 + i);
+
+        masks[i] = masks[4 + i] = 0;
+        if (STPMIC_SLOT_TEST(ctx->owned, slot) && STPMIC_SLOT_TEST(ctx->valid, slot)) {
+            masks[i] = ctx->cache[slot];
+            masks[4 + i] = (stpmic_reg_t) ~ctx->cache[slot];
+            m = 1;
+        }
+    }
+
+    // --> registers are reset to defaults except constant ones, pending batch writes are kept.
+    STPMIC_SEQ_BEGIN(ctx);
+    uint8_t keep = STPMIC_SLOT_TEST(ctx->valid, version) != 0;
+
+    for (uint8_t i = 0; i < sizeof(ctx->valid); ++i) {
+        ctx->valid[i] &= ctx->dirty[i];
+    }
+
+    if (keep) {
+        STPMIC_SLOT_SET(ctx->valid, version);
+    }
+
+    STPMIC_SEQ_END(ctx);
+    STPMIC_RETAIN_SYNC(ctx);
+
+    // --> contiguous owned registers in a burst, values are still in the cache.
+    for (uint16_t reg = 0; reg < STPMIC_REG_MAX; ++reg) {
+        uint8_t slot = STPMIC_SLOT(reg);
+
+        if (!STPMIC_IS_CACHED(reg) || (STPMIC_REGATTR[reg] & STPMIC_REGATTR_RO) ||
+            !STPMIC_SLOT_TEST(ctx->owned, slot) || STPMIC_SLOT_TEST(ctx->dirty, slot))
+        {
+            continue;
+        }
+
+        if (n > 0 && spans[n - 1].reg + spans[n - 1].len == reg && spans[n - 1].len < STPMIC_BURST_MAX &&
+            STPMIC_SLOT_FOLLOWS(reg))
+        {
+            spans[n - 1].len++;
+            continue;
+        }
+
+        // --> keep 2 spans for interrupt masks.
+        if (n >= STPMIC_SPAN_MAX - 2) {
+            if ((ret = __stpmic_xfer_cached(ctx, spans, n, 1)) != STPMIC_RET_OK) {
+                last = ret;
+            }
+
+            n = 0;
+        }
+
+        spans[n].reg = (uint8_t) reg;
+        spans[n].len = 1;
+        spans[n].buf = &ctx->cache[slot];
+        n++;
+    }
+
+    if (m) {
+        spans[n].reg = STPMIC_REG_INT_MASK_SET_R1;
+        spans[n].len = 4;
+        spans[n].buf = &masks[0];
+
+        spans[n + 1].reg = STPMIC_REG_INT_MASK_CLEAR_R1;
+        spans[n + 1].len = 4;
+        spans[n + 1].buf = &masks[4];
+        n += 2;
+    }
+
+    if (n > 0 && (ret = __stpmic_xfer_cached(ctx, spans, n, 1)) != STPMIC_RET_OK) {
+        last = ret;
+    }
+
+    return last;
+}
+
+/* check whether the device was restarted or not. */
+stpmic_ret_t stpmic_ctx_restart_check(stpmic_ctx_t* ctx, uint8_t* out) {
+    stpmic_reg_t srs[sizeof(ctx->status)];
+    uint8_t restarted = 0;
+
+    if (ctx->state < STPMIC_DRV_INIT) {
+        return STPMIC_RET_NODEV;
+    }
+
+    STPMIC_LOCK(ctx);
+
+#if STPMIC_USE_ASYNC
+    if (ctx->async.busy) {
+        STPMIC_UNLOCK(ctx);
+        return STPMIC_RET_BUSY;
+    }
+#endif
+
+    stpmic_ret_t ret = stpmic_ctx_read_burst(ctx, STPMIC_REG_TURN_ON_SR, srs, sizeof(srs));
+    if (ret == STPMIC_RET_OK) {
+        srs[STPMIC_REG_RESTART_SR - STPMIC_REG_TURN_ON_SR] &= STPMIC_RESTARTSR_REASONS;
+
+        // --> the first check takes the reference.
+        restarted = ctx->status_known && memcmp(srs, ctx->status, sizeof(srs)) != 0;
+
+        memcpy(ctx->status, srs, sizeof(ctx->status));
+        ctx->status_known = 1;
+        STPMIC_RETAIN_SYNC(ctx);
+    }
+
+    if (restarted) {
+        ctx->restarts++;
+        ret = __stpmic_restart_apply(ctx);
+    }
+
+    STPMIC_UNLOCK(ctx);
+
+    if (out) {
+        *out = restarted;
+    }
+
+    return ret;
+}
+
+/* clear a register cache. */
+stpmic_ret_t stpmic_ctx_clear_cache(stpmic_ctx_t* ctx, stpmic_regid_t reg) {
+    if (ctx->state < STPMIC_DRV_INIT) {
+        return STPMIC_RET_NODEV;
+    }
+    
+    if (reg >= STPMIC_REG_MAX) {
+        return STPMIC_RET_INVALID;
+    }
+
+    STPMIC_LOCK(ctx);
+    __stpmic_cache_drop(ctx, reg, 1);
+    STPMIC_UNLOCK(ctx);
+
+    return STPMIC_RET_OK;
+}
+
+/* reserve to write a register of STPMIC. */
+stpmic_ret_t stpmic_ctx_batch_write(stpmic_ctx_t* ctx, stpmic_regid_t reg, stpmic_reg_t val) {
+    if (ctx->state < STPMIC_DRV_INIT) {
+        return STPMIC_RET_NODEV;
+    }
+    
+    if (reg >= STPMIC_REG_MAX) {
+        return STPMIC_RET_INVALID;
+    }
+
+    // --> read-only or not cached.
+    if (!STPMIC_IS_CACHED(reg) || (STPMIC_REGATTR[reg] & STPMIC_REGATTR_RO)) {
+        return STPMIC_RET_NOTSUP;
+    }
+
+    STPMIC_LOCK(ctx);
+    STPMIC_SEQ_BEGIN(ctx);
+
+    STPMIC_CACHE_VAL(ctx, reg) = val;
+    STPMIC_SLOT_SET(ctx->valid, STPMIC_SLOT(reg));
+    STPMIC_SET_DIRTY(ctx, reg);
+
+    STPMIC_SEQ_END(ctx);
+    STPMIC_UNLOCK(ctx);
+    return STPMIC_RET_OK;
+}
+
+/* flush all pending batch writes. */
+stpmic_ret_t stpmic_ctx_batch_flush(stpmic_ctx_t* ctx) {
+    if (ctx->state < STPMIC_DRV_INIT) {
+        return STPMIC_RET_NODEV;
+    }
+
+#if STPMIC_USE_ASYNC
+    if (ctx->async.busy) {
+        return STPMIC_RET_BUSY;
+    }
+#endif
+    
+    stpmic_ret_t ret = STPMIC_RET_OK;
+    stpmic_ret_t last = STPMIC_RET_OK;
+    stpmic_span_t spans[STPMIC_SPAN_MAX];
+    uint16_t s = 0;
+    uint8_t n = 0;
+
+    // --> dirty flags shouldn't change while collecting them.
+    STPMIC_LOCK(ctx);
+    while (s < STPMIC_REG_MAX) {
+        if (!STPMIC_IS_CACHED(s) || !STPMIC_IS_DIRTY(ctx, s)) {
+            s++;
+            continue;
+        }
+
+        // --> merge adjacent dirty registers in adjacent slots into a single burst.
+        uint8_t len = 1;
+        while (s + len < STPMIC_REG_MAX && len < STPMIC_BURST_MAX &&
+            STPMIC_IS_CACHED(s + len) && STPMIC_IS_DIRTY(ctx, s + len) && STPMIC_SLOT_FOLLOWS(s + len))
+        {
+            len++;
+        }
+
+        // --> write them from the cache.
+        spans[n].reg = (uint8_t) s;
+        spans[n].len = len;
+        spans[n].buf = &STPMIC_CACHE_VAL(ctx, s);
+        s += len;
+
+        // --> this clears dirty flags of written registers.
+        if (++n >= STPMIC_SPAN_MAX) {
+            if ((ret = __stpmic_xfer_cached(ctx, spans, n, 1)) != STPMIC_RET_OK) {
+                last = ret;
+            }
+
+            n = 0;
+        }
+    }
+
+    if (n > 0 && (ret = __stpmic_xfer_cached(ctx, spans, n, 1)) != STPMIC_RET_OK) {
+        last = ret;
+    }
+
+    STPMIC_UNLOCK(ctx);
+
+    // --> return the last error.
+    return last;
+}
+
+/* reload all cached registers. */
+stpmic_ret_t stpmic_ctx_reload_cache(stpmic_ctx_t* ctx) {
+    if (ctx->state < STPMIC_DRV_INIT) {
+        return STPMIC_RET_NODEV;
+    }
+
+#if STPMIC_USE_ASYNC
+    if (ctx->async.busy) {
+        return STPMIC_RET_BUSY;
+    }
+#endif
+    
+    stpmic_ret_t ret = STPMIC_RET_OK;
+    stpmic_ret_t last = STPMIC_RET_OK;
+    stpmic_span_t spans[STPMIC_SPAN_MAX];
+    stpmic_reg_t buf[STPMIC_SPAN_BUF];
+    uint16_t s = 0;
+    uint8_t n = 0, o = 0;
+    
+    while (s < STPMIC_REG_MAX) {
+        // --> constant ones never change once cached, e.g. VERSION_SR.
+        if (!STPMIC_IS_CACHED(s) ||
+            ((STPMIC_REGATTR[s] & STPMIC_REGATTR_CONST) && __stpmic_cache_hit(ctx, s)))
+        {
+            s++;
+            continue;
+        }
+
+        // --> read cached registers at once, through small gaps between them.
+        uint16_t e = s + 1, end = s + 1;
+        while (e < STPMIC_REG_MAX && e - s < STPMIC_BURST_MAX) {
+            if (STPMIC_IS_CACHED(e)) {
+                end = e + 1;
+            }
+
+            else if (e - end >= STPMIC_SPAN_GAP) {
+                break;
+            }
+
+            e++;
+        }
+
+        spans[n].reg = (uint8_t) s;
+        spans[n].len = (uint8_t)(end - s);
+        spans[n].buf = &buf[o];
+        o += spans[n].len;
+        s = end;
+
+        // --> transfer collected spans if the next one may not fit.
+        if (++n >= STPMIC_SPAN_MAX || o + STPMIC_BURST_MAX > STPMIC_SPAN_BUF) {
+            if ((ret = __stpmic_xfer_cached(ctx, spans, n, 0)) != STPMIC_RET_OK) {
+                last = ret;
+            }
+
+            n = o = 0;
+        }
+    }
+
+    if (n > 0 && (ret = __stpmic_xfer_cached(ctx, spans, n, 0)) != STPMIC_RET_OK) {
+        last = ret;
+    }
+
+    // --> return the last error.
+    return last;
+}
+
+/* begin a deadline. */
+stpmic_ret_t stpmic_ctx_deadline_begin(stpmic_ctx_t* ctx, uint32_t budget) {
+    uint32_t now;
+
+    if (ctx->state < STPMIC_DRV_INIT) {
+        return STPMIC_RET_NODEV;
+    }
+
+    if (!__stpmic_tick(ctx, &now)) {
+        return STPMIC_RET_NOTSUP;
+    }
+
+    // --> released by `stpmic_ctx_deadline_end`.
+    STPMIC_LOCK(ctx);
+    if (ctx->deadline.active) {
+        STPMIC_UNLOCK(ctx);
+        return STPMIC_RET_ALREADY;
+    }
+
+    memset(&ctx->deadline, 0, sizeof(ctx->deadline));
+    ctx->deadline.active = 1;
+    ctx->deadline.start = now;
+    ctx->deadline.budget = budget;
+    ctx->deadline.left = budget;
+    return STPMIC_RET_OK;
+}
+
+/* end the deadline. */
+stpmic_ret_t stpmic_ctx_deadline_end(stpmic_ctx_t* ctx, stpmic_progress_t* out) {
+    uint32_t now;
+
+    if (!ctx->deadline.active) {
+        return STPMIC_RET_INVALID;
+    }
+
+    if (__stpmic_tick(ctx, &now)) {
+        ctx->deadline.progress.elapsed = now - ctx->deadline.start;
+    }
+
+    if (out) {
+        *out = ctx->deadline.progress;
+    }
+
+    stpmic_ret_t ret = ctx->deadline.expired ? STPMIC_RET_DEADLINE : STPMIC_RET_OK;
+
+    ctx->deadline.active = 0;
+    STPMIC_UNLOCK(ctx);
+    return ret;
+}
+
+/* run an operation under a deadline. */
+static stpmic_ret_t __stpmic_within(
+    stpmic_ctx_t* ctx, stpmic_ret_t (*fn)(stpmic_ctx_t*),
+    uint32_t budget, stpmic_progress_t* out)
+{
+    stpmic_ret_t ret = stpmic_ctx_deadline_begin(ctx, budget);
+
+    if (ret != STPMIC_RET_OK) {
+        return ret;
+    }
+
+    ret = fn(ctx);
+    stpmic_ctx_deadline_end(ctx, out);
+    return ret;
+}
+
+/* flush all pending batch writes within the budget. */
+stpmic_ret_t stpmic_ctx_batch_flush_within(stpmic_ctx_t* ctx, uint32_t budget, stpmic_progress_t* out) {
+    return __stpmic_within(ctx, stpmic_ctx_batch_flush, budget, out);
+}
+
+/* reload all cached registers within the budget. */
+stpmic_ret_t stpmic_ctx_reload_cache_within(stpmic_ctx_t* ctx, uint32_t budget, stpmic_progress_t* out) {
+    return __stpmic_within(ctx, stpmic_ctx_reload_cache, budget, out);
+}
+
+/* get the version of STPMIC. */
+stpmic_ret_t stpmic_ctx_version(stpmic_ctx_t* ctx, stpmic_version_t* out) {
+    stpmic_reg_t version_sr;
+    stpmic_ret_t ret = stpmic_ctx_read(ctx, STPMIC_REG_VERSION_SR, &version_sr);
+
+    if (ret != STPMIC_RET_OK) {
+        return ret;
+    }
+
+    if (out) {
+        out->major = (version_sr >> 4) & 0x0fu;
+        out->minor = (version_sr >> 0) & 0x0fu;
+    }
+
+    return STPMIC_RET_OK;
+}
+
+/* get the STPMIC's operating mode. */
+uint8_t stpmic_ctx_opmode_is_main(stpmic_ctx_t* ctx) {
+    stpmic_reg_t reg;
+
+    if (stpmic_ctx_restartsr(ctx, &reg) != STPMIC_RET_OK) {
+        return 0xffu;
+    }
+
+    return reg & STPMIC_RESTARTSR_OP_MODE_MASK;
 }
 
 /* get the LDO4'th input source. */
-uint8_t stpmic_ldo4_src(stpmic_reg_t in) {
+uint8_t stpmic_ctx_ldo4_src(stpmic_ctx_t* ctx, stpmic_reg_t in) {
+    stpmic_reg_t reg;
+
+    (void) in; // --> kept for compatibility, the source is read from `RESTART_SR`.
+
+    if (stpmic_ctx_restartsr(ctx, &reg) != STPMIC_RET_OK) {
+        return 0xffu;
+    }
+
+    return reg & STPMIC_RESTARTSR_LDO4_SRC_MASK;
+}
+
+/* `stpmic_ctx_request_swoff` with the lock held. */
+static stpmic_ret_t __stpmic_request_swoff_locked(stpmic_ctx_t* ctx) {
     stpmic_reg_t reg;
+    stpmic_ret_t ret = stpmic_ctx_maincr(ctx, &reg);
+
+    if (ret != STPMIC_RET_OK) {
+        return ret;
+    }
+
+    reg |= STPMIC_MAINCR_SWOFF;
+    return __stpmic_xfer_command(ctx, STPMIC_REG_MAIN_CR, reg);
+}
+
+/* request `software switch` off. */
+stpmic_ret_t stpmic_ctx_request_swoff(stpmic_ctx_t* ctx) {
+    STPMIC_LOCK(ctx);
+    stpmic_ret_t ret = __stpmic_request_swoff_locked(ctx);
+    STPMIC_UNLOCK(ctx);
+    return ret;
+}
+
+/* `stpmic_ctx_pwrctrl_init` with the lock held. */
+static stpmic_ret_t __stpmic_pwrctrl_init_locked(stpmic_ctx_t* ctx, stpmic_pwrctrl_t* pwrctrl) {
+    stpmic_reg_t mcr = 0;
+    stpmic_ret_t ret = __stpmic_update_bits_locked(
+        ctx, STPMIC_REG_PADS_PULL_CR,
+        STPMIC_PADSPULLCR_PWRCTRL_PD | STPMIC_PADSPULLCR_PWRCTRL_PU,
+        pwrctrl->pull << 2, NULL);
+
+    if (ret != STPMIC_RET_OK) {
+        return ret;
+    }
+
+    if (pwrctrl->pol) {
+        mcr |= STPMIC_MAINCR_PWRCTL_POL;
+    }
+
+    if (pwrctrl->en) {
+        mcr |= STPMIC_MAINCR_PWRCTL_EN;
+    }
+
+    return __stpmic_update_bits_locked(
+        ctx, STPMIC_REG_MAIN_CR,
+        STPMIC_MAINCR_PWRCTL_EN | STPMIC_MAINCR_PWRCTL_POL,
+        mcr, NULL);
+}
+
+/* initialize the PWRCTRL pin's functionality. */
+stpmic_ret_t stpmic_ctx_pwrctrl_init(stpmic_ctx_t* ctx, stpmic_pwrctrl_t* pwrctrl) {
+    STPMIC_LOCK(ctx);
+    stpmic_ret_t ret = __stpmic_pwrctrl_init_locked(ctx, pwrctrl);
+    STPMIC_UNLOCK(ctx);
+    return ret;
+}
+
+/* `stpmic_ctx_pwrctrl_enable` with the lock held. */
+static stpmic_ret_t __stpmic_pwrctrl_enable_locked(stpmic_ctx_t* ctx) {
+    return __stpmic_update_bits_locked(
+        ctx, STPMIC_REG_MAIN_CR, STPMIC_MAINCR_PWRCTL_EN,
+        STPMIC_MAINCR_PWRCTL_EN, NULL);
+}
+
+/* enable the PWRCTRL pin's functionality. */
+stpmic_ret_t stpmic_ctx_pwrctrl_enable(stpmic_ctx_t* ctx) {
+    STPMIC_LOCK(ctx);
+    stpmic_ret_t ret = __stpmic_pwrctrl_enable_locked(ctx);
+    STPMIC_UNLOCK(ctx);
+    return ret;
+}
+
+/* `stpmic_ctx_pwrctrl_disable` with the lock held. */
+static stpmic_ret_t __stpmic_pwrctrl_disable_locked(stpmic_ctx_t* ctx) {
+    return __stpmic_update_bits_locked(
+        ctx, STPMIC_REG_MAIN_CR, STPMIC_MAINCR_PWRCTL_EN, 0, NULL);
+}
+
+/* enable the PWRCTRL pin's functionality. */
+stpmic_ret_t stpmic_ctx_pwrctrl_disable(stpmic_ctx_t* ctx) {
+    STPMIC_LOCK(ctx);
+    stpmic_ret_t ret = __stpmic_pwrctrl_disable_locked(ctx);
+    STPMIC_UNLOCK(ctx);
+    return ret;
+}
+
+/* `stpmic_ctx_pwrctrl_deinit` with the lock held. */
+static stpmic_ret_t __stpmic_pwrctrl_deinit_locked(stpmic_ctx_t* ctx) {
+    stpmic_ret_t ret = __stpmic_update_bits_locked(
+        ctx, STPMIC_REG_PADS_PULL_CR,
+        STPMIC_PADSPULLCR_PWRCTRL_PD | STPMIC_PADSPULLCR_PWRCTRL_PU,
+        0, NULL);
+
+    if (ret != STPMIC_RET_OK) {
+        return ret;
+    }
+
+    return __stpmic_update_bits_locked(
+        ctx, STPMIC_REG_MAIN_CR, STPMIC_MAINCR_PWRCTL_EN, 0, NULL);
+}
+
+/* de-initialize PWRCTRL functionality. */
+stpmic_ret_t stpmic_ctx_pwrctrl_deinit(stpmic_ctx_t* ctx) {
+    STPMIC_LOCK(ctx);
+    stpmic_ret_t ret = __stpmic_pwrctrl_deinit_locked(ctx);
+    STPMIC_UNLOCK(ctx);
+    return ret;
+}
+
+/* `stpmic_ctx_wakeup_init` with the lock held. */
+static stpmic_ret_t __stpmic_wakeup_init_locked(stpmic_ctx_t* ctx, stpmic_wakeup_t* wakeup) {
+    stpmic_reg_t reg = (wakeup->pull << 0) & (
+        STPMIC_PADSPULLCR_WKUP_PD | 
+        STPMIC_PADSPULLCR_WKUP_PU
+    );
+
+    if (wakeup->en) {
+        reg |= STPMIC_PADSPULLCR_WKUP_EN;
+    }
+    
+    return __stpmic_update_bits_locked(
+        ctx, STPMIC_REG_PADS_PULL_CR,
+        STPMIC_PADSPULLCR_WKUP_PD | STPMIC_PADSPULLCR_WKUP_PU | STPMIC_PADSPULLCR_WKUP_EN,
+        reg, NULL);
+}
+
+/* initialize the WAKE-UP pin's functionality. */
+stpmic_ret_t stpmic_ctx_wakeup_init(stpmic_ctx_t* ctx, stpmic_wakeup_t* wakeup) {
+    STPMIC_LOCK(ctx);
+    stpmic_ret_t ret = __stpmic_wakeup_init_locked(ctx, wakeup);
+    STPMIC_UNLOCK(ctx);
+    return ret;
+}
+
+/* `stpmic_ctx_wakeup_deinit` with the lock held. */
+static stpmic_ret_t __stpmic_wakeup_deinit_locked(stpmic_ctx_t* ctx) {
+    return __stpmic_update_bits_locked(
+        ctx, STPMIC_REG_PADS_PULL_CR,
+        STPMIC_PADSPULLCR_WKUP_PD | STPMIC_PADSPULLCR_WKUP_PU | STPMIC_PADSPULLCR_WKUP_EN,
+        0, NULL);
+}
+
+/* de-initialize the WAKE-UP pin's functionality. */
+stpmic_ret_t stpmic_ctx_wakeup_deinit(stpmic_ctx_t* ctx) {
+    STPMIC_LOCK(ctx);
+    stpmic_ret_t ret = __stpmic_wakeup_deinit_locked(ctx);
+    STPMIC_UNLOCK(ctx);
+    return ret;
+}
+
+/* `stpmic_ctx_mrst` with the lock held. */
+static stpmic_ret_t __stpmic_mrst_locked(stpmic_ctx_t* ctx, uint16_t* out) {
+    uint8_t temp[2];
+    stpmic_ret_t ret;
+
+    if ((ret = stpmic_ctx_read(ctx, STPMIC_REG_BUCKS_MRST_CR, &temp[0])) != STPMIC_RET_OK) {
+        return ret;
+    }
+
+    if ((ret = stpmic_ctx_read(ctx, STPMIC_REG_LDOS_MRST_CR, &temp[1])) != STPMIC_RET_OK) {
+        return ret;
+    }
+
+    if (out) {
+        *out = temp[1] | (((uint16_t)temp[0]) << 8);
+    }
+
+    return STPMIC_RET_OK;
+}
+
+/* get the MRST masks from BUCKS_MRST_CR and LDOS_MRST_CR. */
+stpmic_ret_t stpmic_ctx_mrst(stpmic_ctx_t* ctx, uint16_t* out) {
+    STPMIC_LOCK(ctx);
+    stpmic_ret_t ret = __stpmic_mrst_locked(ctx, out);
+    STPMIC_UNLOCK(ctx);
+    return ret;
+}
+
+/* `stpmic_ctx_set_mrst` with the lock held. */
+static stpmic_ret_t __stpmic_set_mrst_locked(stpmic_ctx_t* ctx, uint16_t val) {
+    stpmic_ret_t ret = __stpmic_update_bits_locked(
+        ctx, STPMIC_REG_BUCKS_MRST_CR, 0x0f, (stpmic_reg_t)(val >> 8), NULL);
+
+    if (ret != STPMIC_RET_OK) {
+        return ret;
+    }
+    
+    return __stpmic_update_bits_locked(
+        ctx, STPMIC_REG_LDOS_MRST_CR, 0x7f, (stpmic_reg_t)(val >> 0), NULL);
+}
+
+/* set the MRST masks from BUCKS_MRST_CR and LDOS_MRST_CR. */
+stpmic_ret_t stpmic_ctx_set_mrst(stpmic_ctx_t* ctx, uint16_t val) {
+    STPMIC_LOCK(ctx);
+    stpmic_ret_t ret = __stpmic_set_mrst_locked(ctx, val);
+    STPMIC_UNLOCK(ctx);
+    return ret;
+}
+
+/* `stpmic_ctx_watchdog_init` with the lock held. */
+static stpmic_ret_t __stpmic_watchdog_init_locked(stpmic_ctx_t* ctx, uint8_t sec) {
+    if (sec == 0) {
+        return stpmic_ctx_watchdog_deinit(ctx);
+    }
+
+    /* 0x00 ~ 0xff = 1sec ~ 256sec. */
+    stpmic_ret_t ret = stpmic_ctx_write(ctx, STPMIC_REG_WDG_TMR_CR, sec - 1);
+    if (ret != STPMIC_RET_OK) {
+        return ret;
+    }
+
+    uint8_t cr = (1u << 1) | (sec > 0 ? 0x01 : 0);
+    return stpmic_ctx_write_direct(ctx, STPMIC_REG_WDG_CR, cr);
+}
+
+/* initialize the watchdog timer, sec: 1 ~ 255, 0: disable. */
+stpmic_ret_t stpmic_ctx_watchdog_init(stpmic_ctx_t* ctx, uint8_t sec) {
+    STPMIC_LOCK(ctx);
+    stpmic_ret_t ret = __stpmic_watchdog_init_locked(ctx, sec);
+    STPMIC_UNLOCK(ctx);
+    return ret;
+}
+
+
+/* `stpmic_ctx_watchdog_reset` with the lock held. */
+static stpmic_ret_t __stpmic_watchdog_reset_locked(stpmic_ctx_t* ctx) {
+    stpmic_reg_t reg = 0;
+    stpmic_ret_t ret = stpmic_ctx_read(ctx, STPMIC_REG_WDG_TMR_CR, &reg);
+    if (ret != STPMIC_RET_OK) {
+        return ret;
+    }
+
+    /* (MSB) RESV | RST(1) | ENA(1) (LSB). */
+    if ((reg & (1u << 0)) == 0) {
+        return STPMIC_RET_DISABLED;
+    }
+
+    return stpmic_ctx_write_direct(ctx, STPMIC_REG_WDG_CR, (1u << 1) | (1u << 0));
+}
+
+/* reset the watchdog counter to default counter. */
+stpmic_ret_t stpmic_ctx_watchdog_reset(stpmic_ctx_t* ctx) {
+    STPMIC_LOCK(ctx);
+    stpmic_ret_t ret = __stpmic_watchdog_reset_locked(ctx);
+    STPMIC_UNLOCK(ctx);
+    return ret;
+}
+
+/* encode BUCKx_MAIN_CR or BUCKx_ALT_CR value from options. */
+static uint8_t __stpmic_buck_value(stpmic_buck_t* opts) {
+    uint8_t val = (opts->volts << 2) & 0xfc;
+
+    if (opts->mode) {
+        val |= STPMIC_BIT_MASK(1);
+    }
+
+    if (opts->enable) {
+        val |= STPMIC_BIT_MASK(0);
+    }
+
+    return val;
+}
+
+/* `__stpmic_ctx_buck_setup` with the lock held. */
+static stpmic_ret_t __stpmic_buck_setup_locked(stpmic_ctx_t* ctx, uint8_t nth, uint8_t alt, stpmic_buck_t* opts) {
+    if (nth <= 0 || nth > 4) {
+        return STPMIC_RET_RANGE;
+    }
+
+    if (!opts) {
+        return STPMIC_RET_INVALID;
+    }
+
+    // --> stage into the active transaction, or commit both at once.
+    uint8_t own = __stpmic_txn_open(ctx);
+    stpmic_ret_t ret = __stpmic_txn_stage(
+        ctx, STPMIC_REG_BUCKS_PD_CR,
+        STPMIC_BIT_MASK_VAL((nth - 1) << 1, 0x03u),
+        stpmic_set_buckspd(0, nth, opts->pd));
+
+    if (ret == STPMIC_RET_OK) {
+        ret = __stpmic_txn_stage(
+            ctx, (stpmic_regid_t)((
+                alt 
+                ? STPMIC_REG_BUCKx_ALT_CR 
+                : STPMIC_REG_BUCKx_MAIN_CR
+            ) + (nth - 1)),
+            0xffu, __stpmic_buck_value(opts));
+    }
+
+    return own ? __stpmic_txn_close(ctx, ret) : ret;
+}
+
+/* setup one of buck #1 ~ #4. */
+stpmic_ret_t __stpmic_ctx_buck_setup(stpmic_ctx_t* ctx, uint8_t nth, uint8_t alt, stpmic_buck_t* opts) {
+    STPMIC_LOCK(ctx);
+    stpmic_ret_t ret = __stpmic_buck_setup_locked(ctx, nth, alt, opts);
+    STPMIC_UNLOCK(ctx);
+    return ret;
+}
+
+/* `__stpmic_ctx_buck_enable` with the lock held. */
+static stpmic_ret_t __stpmic_buck_enable_locked(stpmic_ctx_t* ctx, uint8_t nth, uint8_t alt) {
+    if (nth <= 0 || nth > 4) {
+        return STPMIC_RET_RANGE;
+    }
+
+    uint8_t changed = 0;
+    stpmic_ret_t ret = __stpmic_update_bits_locked(
+        ctx, (stpmic_regid_t)((
+            alt 
+            ? STPMIC_REG_BUCKx_ALT_CR 
+            : STPMIC_REG_BUCKx_MAIN_CR
+        ) + (nth - 1)),
+        STPMIC_BIT_MASK(0), STPMIC_BIT_MASK(0), &changed);
+
+    if (ret == STPMIC_RET_OK && !changed) {
+        return STPMIC_RET_ALREADY;
+    }
+
+    return ret;
+}
+
+/**
+ * enable the specified buck converter.
+ * @param nth 1 ~ 4.
+ * @return
+ * `STPMIC_RET_NODEV` if STPMIC driver is not ready.
+ * `STPMIC_RET_TIMEOUT` if timeout reached.
+ * `STPMIC_RET_RANGE` if `nth` value is out of range.
+ */
+stpmic_ret_t __stpmic_ctx_buck_enable(stpmic_ctx_t* ctx, uint8_t nth, uint8_t alt) {
+    STPMIC_LOCK(ctx);
+    stpmic_ret_t ret = __stpmic_buck_enable_locked(ctx, nth, alt);
+    STPMIC_UNLOCK(ctx);
+    return ret;
+}
+
+/* `__stpmic_ctx_buck_disable` with the lock held. */
+static stpmic_ret_t __stpmic_buck_disable_locked(stpmic_ctx_t* ctx, uint8_t nth, uint8_t alt) {
+    if (nth <= 0 || nth > 4) {
+        return STPMIC_RET_RANGE;
+    }
+
+    uint8_t changed = 0;
+    stpmic_ret_t ret = __stpmic_update_bits_locked(
+        ctx, (stpmic_regid_t)((
+            alt 
+            ? STPMIC_REG_BUCKx_ALT_CR 
+            : STPMIC_REG_BUCKx_MAIN_CR
+        ) + (nth - 1)),
+        STPMIC_BIT_MASK(0), 0, &changed);
+
+    if (ret == STPMIC_RET_OK && !changed) {
+        return STPMIC_RET_ALREADY;
+    }
+
+    return ret;
+}
+
+/* disable the specified buck converter. */
+stpmic_ret_t __stpmic_ctx_buck_disable(stpmic_ctx_t* ctx, uint8_t nth, uint8_t alt) {
+    STPMIC_LOCK(ctx);
+    stpmic_ret_t ret = __stpmic_buck_disable_locked(ctx, nth, alt);
+    STPMIC_UNLOCK(ctx);
+    return ret;
+}
+
+/* encode LDOx_MAIN_CR or LDOx_ALT_CR value from options. */
+static stpmic_ret_t __stpmic_ldo_value(uint8_t nth, stpmic_ldo_t* opts, uint8_t* out) {
+    uint8_t val = 0;
+    switch (nth) {
+        case 1: case 2: case 5: case 6: {
+            val = (opts->volts & 0x1f) << 2;
+
+            if (opts->enable) {
+                val |= STPMIC_BIT_MASK(0);
+            }
+            break;
+        }
+
+        case 3: {
+            val = (opts->volts & 0x1f) << 2;
+
+            if (opts->bypass) {
+                val |= STPMIC_BIT_MASK(7);
+            }
+
+            if (opts->enable) {
+                val |= STPMIC_BIT_MASK(0);
+            }
+            break;
+        }
+        case 4: {
+            switch (opts->src) {
+                case STPMIC_LDO4SRC_VIN:
+                    val |= STPMIC_BIT_MASK(2);
+                    break;
+
+                case STPMIC_LDO4SRC_BSTOUT:
+                    val |= STPMIC_BIT_MASK(3);
+                    break;
+
+                case STPMIC_LDO4SRC_VBUSOTG:
+                    val |= STPMIC_BIT_MASK(4);
+                    break;
+                
+                case STPMIC_LDO4SRC_UNKNOWN: // --> automatic for all bits.
+                default:
+                    break;
+            }
+
+            if (opts->src != STPMIC_LDO4SRC_OFF &&
+                opts->enable) 
+            {
+                val |= STPMIC_BIT_MASK(0);
+            }
+            break;
+        }
+
+        default:
+            return STPMIC_RET_RANGE;
+    }
+
+    *out = val;
+    return STPMIC_RET_OK;
+}
+
+/* `__stpmic_ctx_ldo_setup` with the lock held. */
+static stpmic_ret_t __stpmic_ldo_setup_locked(stpmic_ctx_t* ctx, uint8_t nth, uint8_t alt, stpmic_ldo_t* opts) {
+    stpmic_reg_t ldo;
+    stpmic_ret_t ret;
+    uint8_t own, val = 0;
+
+    if (nth < 1 || nth > 6) {
+        return STPMIC_RET_RANGE;
+    }
+
+    if (alt) {
+        ldo = (stpmic_reg_t)(STPMIC_REG_LDOx_ALT_CR + (nth - 1));
+    } else {
+        ldo = (stpmic_reg_t)(STPMIC_REG_LDOx_MAIN_CR + (nth - 1));
+    }
+
+    if ((ret = __stpmic_ldo_value(nth, opts, &val)) != STPMIC_RET_OK) {
+        return ret;
+    }
+
+    // --> stage into the active transaction, or commit both at once.
+    own = __stpmic_txn_open(ctx);
+
+    if (nth <= 4) {
+        ret = __stpmic_txn_stage(
+            ctx, STPMIC_REG_LDO1234_PD_CR,
+            STPMIC_BIT_MASK_VAL((nth - 1) << 1, 0x03u),
+            stpmic_set_ldo1234pd(0, nth, opts->pd));
+    }
+
+    else {
+        ret = __stpmic_txn_stage(
+            ctx, STPMIC_REG_LDO56_VREF_PD_CR,
+            STPMIC_BIT_MASK_VAL((nth - 5) << 1, 0x03u),
+            stpmic_set_ldo56pd(0, nth, opts->pd));
+    }
+
+    if (ret == STPMIC_RET_OK) {
+        ret = __stpmic_txn_stage(ctx, (stpmic_regid_t) ldo, 0xffu, val);
+    }
 
-    if (stpmic_restartsr(&reg) != STPMIC_RET_OK) {
-        return 0xffu;
+    return own ? __stpmic_txn_close(ctx, ret) : ret;
+}
+
+/* setup the specified LDO. */
+stpmic_ret_t __stpmic_ctx_ldo_setup(stpmic_ctx_t* ctx, uint8_t nth, uint8_t alt, stpmic_ldo_t* opts) {
+    STPMIC_LOCK(ctx);
+    stpmic_ret_t ret = __stpmic_ldo_setup_locked(ctx, nth, alt, opts);
+    STPMIC_UNLOCK(ctx);
+    return ret;
+}
+
+/* `__stpmic_ctx_ldo_enable` with the lock held. */
+static stpmic_ret_t __stpmic_ldo_enable_locked(stpmic_ctx_t* ctx, uint8_t nth, uint8_t alt) {
+    if (nth <= 0 || nth > 6) {
+        return STPMIC_RET_RANGE;
     }
 
-    return reg & STPMIC_RESTARTSR_LDO4_SRC_MASK;
+    uint8_t changed = 0;
+    stpmic_ret_t ret = __stpmic_update_bits_locked(
+        ctx, (stpmic_regid_t)((
+            alt ? STPMIC_REG_LDOx_ALT_CR : STPMIC_REG_LDOx_MAIN_CR
+        ) + (nth - 1)),
+        STPMIC_BIT_MASK(0), STPMIC_BIT_MASK(0), &changed);
+
+    if (ret == STPMIC_RET_OK && !changed) {
+        return STPMIC_RET_ALREADY;
+    }
+
+    return ret;
 }
 
-/* request `software switch` off. */
-stpmic_ret_t stpmic_request_swoff() {
-    stpmic_reg_t reg;
-    stpmic_ret_t ret = stpmic_maincr(&reg);
+/* enable the specified LDO. */
+stpmic_ret_t __stpmic_ctx_ldo_enable(stpmic_ctx_t* ctx, uint8_t nth, uint8_t alt) {
+    STPMIC_LOCK(ctx);
+    stpmic_ret_t ret = __stpmic_ldo_enable_locked(ctx, nth, alt);
+    STPMIC_UNLOCK(ctx);
+    return ret;
+}
 
-    if (ret != STPMIC_RET_OK) {
-        return ret;
+/* `__stpmic_ctx_ldo_disable` with the lock held. */
+static stpmic_ret_t __stpmic_ldo_disable_locked(stpmic_ctx_t* ctx, uint8_t nth, uint8_t alt) {
+    if (nth <= 0 || nth > 6) {
+        return STPMIC_RET_RANGE;
     }
 
-    reg |= STPMIC_MAINCR_SWOFF;
-    return stpmic_write_direct(STPMIC_REG_MAIN_CR, reg);
+    uint8_t changed = 0;
+    stpmic_ret_t ret = __stpmic_update_bits_locked(
+        ctx, (stpmic_regid_t)((
+            alt ? STPMIC_REG_LDOx_ALT_CR : STPMIC_REG_LDOx_MAIN_CR
+        ) + (nth - 1)),
+        STPMIC_BIT_MASK(0), 0, &changed);
+
+    if (ret == STPMIC_RET_OK && !changed) {
+        return STPMIC_RET_ALREADY;
+    }
+
+    return ret;
 }
 
-/* initialize the PWRCTRL pin's functionality. */
-stpmic_ret_t stpmic_pwrctrl_init(stpmic_pwrctrl_t* pwrctrl) {
-    stpmic_reg_t mcr, ppcr;
-    stpmic_ret_t ret = stpmic_maincr(&mcr);
+/* disable the specified LDO. */
+stpmic_ret_t __stpmic_ctx_ldo_disable(stpmic_ctx_t* ctx, uint8_t nth, uint8_t alt) {
+    STPMIC_LOCK(ctx);
+    stpmic_ret_t ret = __stpmic_ldo_disable_locked(ctx, nth, alt);
+    STPMIC_UNLOCK(ctx);
+    return ret;
+}
+
+/* `__stpmic_ctx_refddr_enable` with the lock held. */
+static stpmic_ret_t __stpmic_refddr_enable_locked(stpmic_ctx_t* ctx, uint8_t alt) {
+    return __stpmic_update_bits_locked(
+        ctx, alt ? STPMIC_REG_REFDDR_ALT_CR : STPMIC_REG_REFDDR_MAIN_CR,
+        STPMIC_BIT_MASK(0), STPMIC_BIT_MASK(0), NULL);
+}
+
+/* enable the REFDDR. */
+stpmic_ret_t __stpmic_ctx_refddr_enable(stpmic_ctx_t* ctx, uint8_t alt) {
+    STPMIC_LOCK(ctx);
+    stpmic_ret_t ret = __stpmic_refddr_enable_locked(ctx, alt);
+    STPMIC_UNLOCK(ctx);
+    return ret;
+}
+
+/* `__stpmic_ctx_refddr_disable` with the lock held. */
+static stpmic_ret_t __stpmic_refddr_disable_locked(stpmic_ctx_t* ctx, uint8_t alt) {
+    return __stpmic_update_bits_locked(
+        ctx, alt ? STPMIC_REG_REFDDR_ALT_CR : STPMIC_REG_REFDDR_MAIN_CR,
+        STPMIC_BIT_MASK(0), 0, NULL);
+}
+
+/* disable the REFDDR. */
+stpmic_ret_t __stpmic_ctx_refddr_disable(stpmic_ctx_t* ctx, uint8_t alt) {
+    STPMIC_LOCK(ctx);
+    stpmic_ret_t ret = __stpmic_refddr_disable_locked(ctx, alt);
+    STPMIC_UNLOCK(ctx);
+    return ret;
+}
 
+/* `stpmic_ctx_interrupt_pending` with the lock held. */
+static stpmic_ret_t __stpmic_interrupt_pending_locked(stpmic_ctx_t* ctx, uint32_t* out) {
+    stpmic_reg_t regs[4];
+    uint32_t val = 0;
+
+    // --> R1 ~ R4 in a single burst.
+    stpmic_ret_t ret = stpmic_ctx_read_burst(ctx, STPMIC_REG_INT_PENDING_R1, regs, 4);
     if (ret != STPMIC_RET_OK) {
         return ret;
     }
 
-    if ((ret = stpmic_padspullcr(&ppcr)) != STPMIC_RET_OK) {
-        return ret;
+    for (uint8_t i = 0; i < 4; ++i) {
+        val |= ((uint32_t) regs[i]) << (i << 3);
     }
 
-    mcr &= ~STPMIC_MAINCR_PWRCTL_EN;
-    mcr &= ~STPMIC_MAINCR_PWRCTL_POL;
-    ppcr &= ~(
-        STPMIC_PADSPULLCR_PWRCTRL_PD |
-        STPMIC_PADSPULLCR_PWRCTRL_PU
-    );
+    if (out) {
+        *out = val;
+    }
 
-    if (pwrctrl->pol) {
-        mcr |= STPMIC_MAINCR_PWRCTL_POL;
+    return STPMIC_RET_OK;
+}
+
+/* read `INT_PENDING_Rx` register. */
+stpmic_ret_t stpmic_ctx_interrupt_pending(stpmic_ctx_t* ctx, uint32_t* out) {
+    STPMIC_LOCK(ctx);
+    stpmic_ret_t ret = __stpmic_interrupt_pending_locked(ctx, out);
+    STPMIC_UNLOCK(ctx);
+    return ret;
+}
+
+/* `stpmic_ctx_interrupt_clear` with the lock held. */
+static stpmic_ret_t __stpmic_interrupt_clear_locked(stpmic_ctx_t* ctx, uint32_t bitmap) {
+    stpmic_reg_t regs[4];
+    uint8_t s = 0, e = 3;
+
+    if (!bitmap) {
+        return STPMIC_RET_OK;
     }
 
-    if (pwrctrl->en) {
-        mcr |= STPMIC_MAINCR_PWRCTL_EN;
+    // --> write only the span of non-zero bytes.
+    while (((bitmap >> (s << 3)) & 0xffu) == 0) s++;
+    while (((bitmap >> (e << 3)) & 0xffu) == 0) e--;
+
+    for (uint8_t i = s; i <= e; ++i) {
+        regs[i - s] = (uint8_t)(bitmap >> (i << 3));
     }
 
-    ppcr |= (pwrctrl->pull << 2) & (
-        STPMIC_PADSPULLCR_PWRCTRL_PD |
-        STPMIC_PADSPULLCR_PWRCTRL_PU
-    );
-    
-    if ((ret = stpmic_write(STPMIC_REG_PADS_PULL_CR, ppcr)) != STPMIC_RET_OK) {
-        return ret;
+    return stpmic_ctx_write_burst(ctx, (stpmic_regid_t)(STPMIC_REG_INT_CLEAR_R1 + s), regs, e - s + 1);
+}
+
+/* clear interrupts. */
+stpmic_ret_t stpmic_ctx_interrupt_clear(stpmic_ctx_t* ctx, uint32_t bitmap) {
+    STPMIC_LOCK(ctx);
+    stpmic_ret_t ret = __stpmic_interrupt_clear_locked(ctx, bitmap);
+    STPMIC_UNLOCK(ctx);
+    return ret;
+}
+
+/* `stpmic_ctx_interrupt_read_mask` with the lock held. */
+static stpmic_ret_t __stpmic_interrupt_read_mask_locked(stpmic_ctx_t* ctx, uint32_t* out) {
+    uint32_t val = 0;
+
+    for (uint8_t i = 0; i < 4; ++i) {
+        stpmic_reg_t reg;
+        stpmic_ret_t ret = stpmic_ctx_read(ctx, (stpmic_regid_t)(STPMIC_REG_INT_MASK_R1 + i), &reg);
+
+        if (ret != STPMIC_RET_OK) {
+            return ret;
+        }
+
+        val |= ((uint32_t)reg) << (i << 3);
+    }
+
+    if (out) {
+        *out = val;
     }
 
-    return stpmic_write(STPMIC_REG_MAIN_CR, mcr);
+    return STPMIC_RET_OK;
 }
 
-/* enable the PWRCTRL pin's functionality. */
-stpmic_ret_t stpmic_pwrctrl_enable() {
-    stpmic_reg_t mcr;
-    stpmic_ret_t ret = stpmic_maincr(&mcr);
+/* mask an interrupt. */
+stpmic_ret_t stpmic_ctx_interrupt_read_mask(stpmic_ctx_t* ctx, uint32_t* out) {
+    STPMIC_LOCK(ctx);
+    stpmic_ret_t ret = __stpmic_interrupt_read_mask_locked(ctx, out);
+    STPMIC_UNLOCK(ctx);
+    return ret;
+}
 
-    if (ret != STPMIC_RET_OK) {
-        return ret;
+/* `stpmic_ctx_interrupt_mask_set` with the lock held. */
+static stpmic_ret_t __stpmic_interrupt_mask_set_locked(stpmic_ctx_t* ctx, uint32_t bitmap) {
+    for (uint8_t i = 0; i < 4; ++i) {
+        const uint8_t u8 = bitmap >> (i << 3);
+        if (u8 == 0) {
+            continue;
+        }
+
+        stpmic_ret_t ret = stpmic_ctx_write(ctx, (stpmic_regid_t)(STPMIC_REG_INT_MASK_SET_R1 + i), u8);
+
+        if (ret != STPMIC_RET_OK) {
+            return ret;
+        }
     }
 
-    mcr |= STPMIC_MAINCR_PWRCTL_EN;
-    return stpmic_write(STPMIC_REG_MAIN_CR, mcr);
+    return STPMIC_RET_OK;
 }
 
-/* enable the PWRCTRL pin's functionality. */
-stpmic_ret_t stpmic_pwrctrl_disable() {
-    stpmic_reg_t mcr;
-    stpmic_ret_t ret = stpmic_maincr(&mcr);
+/* set interrupt masks. */
+stpmic_ret_t stpmic_ctx_interrupt_mask_set(stpmic_ctx_t* ctx, uint32_t bitmap) {
+    STPMIC_LOCK(ctx);
+    stpmic_ret_t ret = __stpmic_interrupt_mask_set_locked(ctx, bitmap);
+    STPMIC_UNLOCK(ctx);
+    return ret;
+}
+
+/* `stpmic_ctx_interrupt_mask_clear` with the lock held. */
+static stpmic_ret_t __stpmic_interrupt_mask_clear_locked(stpmic_ctx_t* ctx, uint32_t bitmap) {
+    for (uint8_t i = 0; i < 4; ++i) {
+        const uint8_t u8 = bitmap >> (i << 3);
+        if (u8 == 0) {
+            continue;
+        }
+
+        stpmic_ret_t ret = stpmic_ctx_write(ctx, (stpmic_regid_t)(STPMIC_REG_INT_MASK_CLEAR_R1 + i), u8);
+
+        if (ret != STPMIC_RET_OK) {
+            return ret;
+        }
+    }
+
+    return STPMIC_RET_OK;
+}
+
+/* clear interrupt masks. */
+stpmic_ret_t stpmic_ctx_interrupt_mask_clear(stpmic_ctx_t* ctx, uint32_t bitmap) {
+    STPMIC_LOCK(ctx);
+    stpmic_ret_t ret = __stpmic_interrupt_mask_clear_locked(ctx, bitmap);
+    STPMIC_UNLOCK(ctx);
+    return ret;
+}
+
+/* `stpmic_ctx_interrupt_read_source` with the lock held. */
+static stpmic_ret_t __stpmic_interrupt_read_source_locked(stpmic_ctx_t* ctx, uint32_t* out) {
+    uint32_t val = 0;
+
+    for (uint8_t i = 0; i < 4; ++i) {
+        stpmic_reg_t reg;
+        stpmic_ret_t ret = stpmic_ctx_read(ctx, (stpmic_regid_t)(STPMIC_REG_INT_SRC_R1 + i), &reg);
+
+        if (ret != STPMIC_RET_OK) {
+            return ret;
+        }
+
+        val |= ((uint32_t)reg) << (i << 3);
+    }
+
+    if (out) {
+        *out = val;
+    }
+
+    return STPMIC_RET_OK;
+}
+
+/* read interrupt sources. */
+stpmic_ret_t stpmic_ctx_interrupt_read_source(stpmic_ctx_t* ctx, uint32_t* out) {
+    STPMIC_LOCK(ctx);
+    stpmic_ret_t ret = __stpmic_interrupt_read_source_locked(ctx, out);
+    STPMIC_UNLOCK(ctx);
+    return ret;
+}
+
+/* deprecated, `INT_SRC_Rx` are read-only: clears pending interrupts instead. */
+stpmic_ret_t stpmic_ctx_interrupt_write_source(stpmic_ctx_t* ctx, uint32_t bitmap) {
+    return stpmic_ctx_interrupt_clear(ctx, bitmap);
+}
+
+#if STPMIC_EVLOG_SIZE
+/* log an occurrence of a flag, returns 0 if its handler exceeds the rate limit. */
+static uint8_t __stpmic_evlog_record(stpmic_ctx_t* ctx, uint8_t n, uint32_t now) {
+    const uint8_t seq = ctx->evlog.open[n];
+    stpmic_event_t* ev = &ctx->evlog.ring[seq & (STPMIC_EVLOG_SIZE - 1)];
+
+    if (!ctx->evlog.enabled) {
+        return 1;
+    }
+
+    // --> a new window of the flag.
+    if (now - ctx->evlog.start[n] >= ctx->evlog.opts.window) {
+        ctx->evlog.start[n] = now;
+        ctx->evlog.calls[n] = 0;
+        ev = NULL;
+    }
+
+    // --> the entry was read or overwritten.
+    else if ((uint8_t)(seq - ctx->evlog.tail) >= (uint8_t)(ctx->evlog.head - ctx->evlog.tail) || ev->bit != n) {
+        ev = NULL;
+    }
+
+    if (ev) {
+        ev->last = now;
+        if (ev->count < 0xffffu) {
+            ev->count++;
+        }
+    }
+
+    else {
+        // --> full: overwrite the oldest entry.
+        if ((uint8_t)(ctx->evlog.head - ctx->evlog.tail) >= STPMIC_EVLOG_SIZE) {
+            ctx->evlog.tail++;
+            ctx->evlog.dropped++;
+        }
+
+        ev = &ctx->evlog.ring[ctx->evlog.head & (STPMIC_EVLOG_SIZE - 1)];
+        ev->bit = n;
+        ev->count = 1;
+        ev->first = now;
+        ev->last = now;
+
+        ctx->evlog.open[n] = ctx->evlog.head++;
+    }
+
+    if (ctx->evlog.opts.limit[n] && ctx->evlog.calls[n] >= ctx->evlog.opts.limit[n]) {
+        ctx->evlog.suppressed++;
+        return 0;
+    }
+
+    ctx->evlog.calls[n]++;
+    return 1;
+}
+#endif
+
+#if STPMIC_USE_OCP_POLICY
+/* rail of an interrupt flag by bit number, `STPMIC_OCP_RAILS` if none. */
+static uint8_t __stpmic_ocp_rail(uint8_t n) {
+    if (n >= 8 && n <= 11) {
+        return (uint8_t)(STPMIC_OCP_BUCK1 + (n - 8));
+    }
+
+    if (n >= 16 && n <= 21) {
+        return (uint8_t)(STPMIC_OCP_LDO1 + (n - 16));
+    }
+
+    return n == 13 ? STPMIC_OCP_SWOUT : STPMIC_OCP_RAILS;
+}
+
+/* main control register of a rail, 0 if none. */
+static uint8_t __stpmic_ocp_reg(uint8_t rail) {
+    if (rail <= STPMIC_OCP_BUCK4) {
+        return (uint8_t)(STPMIC_REG_BUCKx_MAIN_CR + (rail - STPMIC_OCP_BUCK1));
+    }
+
+    if (rail <= STPMIC_OCP_LDO6) {
+        return (uint8_t)(STPMIC_REG_LDOx_MAIN_CR + (rail - STPMIC_OCP_LDO1));
+    }
+
+    return 0;
+}
+
+/* get the value of a control register to respond with, read only if neither cached nor written. */
+static stpmic_ret_t __stpmic_ocp_value(stpmic_ctx_t* ctx, uint8_t reg, stpmic_reg_t* out) {
+    const uint8_t slot = STPMIC_SLOT(reg);
+
+    // --> a written value stays known after invalidation, `stpmic_ctx_ocp_setup` loaded the others.
+    if (STPMIC_SLOT_TEST(ctx->valid, slot) || STPMIC_SLOT_TEST(ctx->owned, slot)) {
+        *out = ctx->cache[slot];
+        return STPMIC_RET_OK;
+    }
+
+    return stpmic_ctx_read(ctx, (stpmic_regid_t) reg, out);
+}
+
+/* write a control register from its known value. */
+static stpmic_ret_t __stpmic_ocp_write(stpmic_ctx_t* ctx, uint8_t reg, stpmic_reg_t clr, stpmic_reg_t set) {
+    stpmic_reg_t val;
+    stpmic_ret_t ret = __stpmic_ocp_value(ctx, reg, &val);
 
     if (ret != STPMIC_RET_OK) {
         return ret;
     }
 
-    mcr &= ~STPMIC_MAINCR_PWRCTL_EN;
-    return stpmic_write(STPMIC_REG_MAIN_CR, mcr);
+    val = (stpmic_reg_t)((val & ~clr) | set);
+    stpmic_span_t span = { reg, 1, &val };
+
+    return __stpmic_xfer_cached(ctx, &span, 1, 1);
 }
 
-/* de-initialize PWRCTRL functionality. */
-stpmic_ret_t stpmic_pwrctrl_deinit() {
-    stpmic_reg_t mcr, ppcr;
-    stpmic_ret_t ret = stpmic_maincr(&mcr);
+/* enable or disable a rail, using the cached control register. */
+static stpmic_ret_t __stpmic_ocp_switch(stpmic_ctx_t* ctx, uint8_t rail, uint8_t enable) {
+    const stpmic_reg_t en = STPMIC_BIT_MASK(0);
+    return __stpmic_ocp_write(ctx, __stpmic_ocp_reg(rail), enable ? 0 : en, enable ? en : 0);
+}
+
+/* respond to an overcurrent flag by the policy, `acted` is set to 1 if responded. */
+static stpmic_ret_t __stpmic_ocp_respond(stpmic_ctx_t* ctx, uint8_t n, uint32_t now, uint8_t* acted) {
+    const uint8_t rail = __stpmic_ocp_rail(n);
+    const stpmic_ocp_rule_t* rule;
+    uint16_t bit;
+    uint8_t action;
+
+    *acted = 0;
+    if (!ctx->ocp.enabled || rail >= STPMIC_OCP_RAILS) {
+        return STPMIC_RET_OK;
+    }
+
+    rule = &ctx->ocp.opts.rails[rail];
+    bit = (uint16_t)(1u << rail);
+    action = rule->action;
+
+    if (action == STPMIC_OCP_RETRY) {
+        // --> already disabled, waiting for the retry.
+        if (ctx->ocp.waiting & bit) {
+            *acted = 1;
+            return STPMIC_RET_OK;
+        }
+
+        // --> ran longer than the longest backoff since the last retry: start over.
+        if (ctx->ocp.tries[rail] && now - ctx->ocp.due[rail] >= ((uint32_t) rule->backoff << rule->retries)) {
+            ctx->ocp.tries[rail] = 0;
+        }
+
+        if (ctx->ocp.tries[rail] >= rule->retries) {
+            action = rule->escalate;
+        }
+
+        else {
+            ctx->ocp.due[rail] = now + ((uint32_t) rule->backoff << ctx->ocp.tries[rail]++);
+            ctx->ocp.waiting |= bit;
+            action = STPMIC_OCP_DISABLE;
+        }
+    }
+
+    if (action == STPMIC_OCP_IGNORE) {
+        return STPMIC_RET_OK;
+    }
+
+    *acted = 1;
+    ctx->ocp.trips++;
+
+    // --> a command, sent without the cache not to be applied again.
+    if (action == STPMIC_OCP_SWOFF) {
+        stpmic_reg_t mcr;
+        stpmic_ret_t ret = __stpmic_ocp_value(ctx, STPMIC_REG_MAIN_CR, &mcr);
+
+        return ret != STPMIC_RET_OK ? ret : __stpmic_xfer_command(ctx, STPMIC_REG_MAIN_CR, mcr | STPMIC_MAINCR_SWOFF);
+    }
+
+    return __stpmic_ocp_switch(ctx, rail, 0);
+}
+#endif
+
+/* `stpmic_ctx_interrupt_dispatch` with the lock held. */
+static stpmic_ret_t __stpmic_interrupt_dispatch_locked(
+    stpmic_ctx_t* ctx, const stpmic_irq_handler_t* handlers, void* arg, uint32_t* out)
+{
+    uint32_t pending, acked = 0;
+    stpmic_ret_t ret = __stpmic_interrupt_pending_locked(ctx, &pending);
+    stpmic_ret_t first = STPMIC_RET_OK;
 
     if (ret != STPMIC_RET_OK) {
         return ret;
     }
 
-    if ((ret = stpmic_padspullcr(&ppcr)) != STPMIC_RET_OK) {
-        return ret;
+#if STPMIC_EVLOG_SIZE || STPMIC_USE_OCP_POLICY
+    uint32_t now = 0;
+    __stpmic_tick(ctx, &now);
+#endif
+
+    // --> visit set bits only, lowest first.
+    while (pending) {
+        const uint8_t n = STPMIC_CTZ(pending);
+        const uint32_t flag = ((uint32_t) 1) << n;
+
+        pending &= pending - 1;
+
+#if STPMIC_USE_OCP_POLICY
+        // --> protective response first, regardless of rate limits.
+        // --> a failed one is reported after the pass, other flags are served anyway.
+        uint8_t acted;
+        if ((ret = __stpmic_ocp_respond(ctx, n, now, &acted)) != STPMIC_RET_OK && first == STPMIC_RET_OK) {
+            first = ret;
+        }
+
+        if (acted) {
+            acked |= flag;
+        }
+#endif
+
+#if STPMIC_EVLOG_SIZE
+        // --> over the rate limit: logged, cleared without the handler.
+        if (!__stpmic_evlog_record(ctx, n, now)) {
+            acked |= flag;
+            continue;
+        }
+#endif
+
+        if (handlers[n] && handlers[n](ctx, flag, arg)) {
+            acked |= flag;
+        }
+    }
+
+    if (out) {
+        *out = acked;
     }
 
-    mcr &= ~STPMIC_MAINCR_PWRCTL_EN;
-    ppcr &= ~(
-        STPMIC_PADSPULLCR_PWRCTRL_PD |
-        STPMIC_PADSPULLCR_PWRCTRL_PU
-    );
-    
-    if ((ret = stpmic_write(STPMIC_REG_PADS_PULL_CR, ppcr)) != STPMIC_RET_OK) {
-        return ret;
+    ret = __stpmic_interrupt_clear_locked(ctx, acked);
+    return first != STPMIC_RET_OK ? first : ret;
+}
+
+/* read pending interrupts, call handlers of them and clear acknowledged ones. */
+stpmic_ret_t stpmic_ctx_interrupt_dispatch(
+    stpmic_ctx_t* ctx, const stpmic_irq_handler_t* handlers, void* arg, uint32_t* out)
+{
+    if (out) {
+        *out = 0;
+    }
+
+    if (!handlers) {
+        return STPMIC_RET_INVALID;
+    }
+
+    STPMIC_LOCK(ctx);
+    stpmic_ret_t ret = __stpmic_interrupt_dispatch_locked(ctx, handlers, arg, out);
+    STPMIC_UNLOCK(ctx);
+    return ret;
+}
+
+#if STPMIC_EVLOG_SIZE
+/* set up the event log. */
+stpmic_ret_t stpmic_ctx_evlog_setup(stpmic_ctx_t* ctx, const stpmic_evlog_t* in) {
+    uint32_t now;
+
+    if (in && !__stpmic_tick(ctx, &now)) {
+        return STPMIC_RET_NOTSUP;
+    }
+
+    STPMIC_LOCK(ctx);
+    memset(&ctx->evlog, 0, sizeof(ctx->evlog));
+
+    if (in) {
+        ctx->evlog.opts = *in;
+        ctx->evlog.enabled = 1;
     }
 
-    return stpmic_write(STPMIC_REG_MAIN_CR, mcr);
+    STPMIC_UNLOCK(ctx);
+    return STPMIC_RET_OK;
 }
 
-/* initialize the WAKE-UP pin's functionality. */
-stpmic_ret_t stpmic_wakeup_init(stpmic_wakeup_t* wakeup) {
-    stpmic_reg_t reg;
-    stpmic_ret_t ret = stpmic_padspullcr(&reg);
+/* read and remove the oldest entries of the event log. */
+stpmic_ret_t stpmic_ctx_evlog_read(stpmic_ctx_t* ctx, stpmic_event_t* out, uint8_t max, uint8_t* count) {
+    uint8_t n = 0;
 
-    if (ret != STPMIC_RET_OK) {
-        return ret;
+    if (!out) {
+        return STPMIC_RET_INVALID;
     }
 
-    reg &= ~(STPMIC_PADSPULLCR_WKUP_PD | STPMIC_PADSPULLCR_WKUP_PU);
-    reg &= ~STPMIC_PADSPULLCR_WKUP_EN;
+    STPMIC_LOCK(ctx);
+    while (n < max && ctx->evlog.tail != ctx->evlog.head) {
+        out[n++] = ctx->evlog.ring[ctx->evlog.tail++ & (STPMIC_EVLOG_SIZE - 1)];
+    }
 
-    reg |= (wakeup->pull << 0) & (
-        STPMIC_PADSPULLCR_WKUP_PD | 
-        STPMIC_PADSPULLCR_WKUP_PU
-    );
+    STPMIC_UNLOCK(ctx);
 
-    if (wakeup->en) {
-        reg |= STPMIC_PADSPULLCR_WKUP_EN;
+    if (count) {
+        *count = n;
     }
-    
-    return stpmic_write(STPMIC_REG_PADS_PULL_CR, reg);
+
+    return STPMIC_RET_OK;
 }
+#endif
 
-/* de-initialize the WAKE-UP pin's functionality. */
-stpmic_ret_t stpmic_wakeup_deinit() {
-    stpmic_reg_t reg;
-    stpmic_ret_t ret = stpmic_padspullcr(&reg);
+#if STPMIC_USE_OCP_POLICY
+/* set up the overcurrent policy. */
+stpmic_ret_t stpmic_ctx_ocp_setup(stpmic_ctx_t* ctx, const stpmic_ocp_policy_t* in) {
+    stpmic_ret_t ret = STPMIC_RET_OK;
+    uint8_t retry = 0, swoff = 0;
+    uint32_t now;
 
-    if (ret != STPMIC_RET_OK) {
-        return ret;
+    if (ctx->state < STPMIC_DRV_INIT) {
+        return STPMIC_RET_NODEV;
     }
 
-    reg &= ~(STPMIC_PADSPULLCR_WKUP_PD | STPMIC_PADSPULLCR_WKUP_PU);
-    reg &= ~STPMIC_PADSPULLCR_WKUP_EN;
-    
-    return stpmic_write(STPMIC_REG_PADS_PULL_CR, reg);
-}
+    for (uint8_t i = 0; in && i < STPMIC_OCP_RAILS; ++i) {
+        const stpmic_ocp_rule_t* rule = &in->rails[i];
+        uint8_t action = rule->action;
 
-/* get the MRST masks from BUCKS_MRST_CR and LDOS_MRST_CR. */
-stpmic_ret_t stpmic_mrst(uint16_t* out) {
-    uint8_t temp[2];
-    stpmic_ret_t ret;
+        if (action > STPMIC_OCP_SWOFF) {
+            return STPMIC_RET_INVALID;
+        }
 
-    if ((ret = stpmic_read(STPMIC_REG_BUCKS_MRST_CR, &temp[0])) != STPMIC_RET_OK) {
-        return ret;
-    }
+        if (action == STPMIC_OCP_RETRY) {
+            if (!rule->retries || rule->retries > 15 || !rule->backoff ||
+                (rule->escalate != STPMIC_OCP_DISABLE && rule->escalate != STPMIC_OCP_SWOFF))
+            {
+                return STPMIC_RET_INVALID;
+            }
 
-    if ((ret = stpmic_read(STPMIC_REG_LDOS_MRST_CR, &temp[1])) != STPMIC_RET_OK) {
-        return ret;
+            action = rule->escalate;
+            retry = 1;
+        }
+
+        if (action == STPMIC_OCP_SWOFF) {
+            swoff = 1;
+        }
+
+        if ((rule->action == STPMIC_OCP_DISABLE || rule->action == STPMIC_OCP_RETRY) && !__stpmic_ocp_reg(i)) {
+            return STPMIC_RET_NOTSUP;
+        }
     }
 
-    if (out) {
-        *out = temp[1] | (((uint16_t)temp[0]) << 8);
+    if (retry && !__stpmic_tick(ctx, &now)) {
+        return STPMIC_RET_NOTSUP;
     }
 
-    return STPMIC_RET_OK;
-}
+    STPMIC_LOCK(ctx);
+    memset(&ctx->ocp, 0, sizeof(ctx->ocp));
 
-/* set the MRST masks from BUCKS_MRST_CR and LDOS_MRST_CR. */
-stpmic_ret_t stpmic_set_mrst(uint16_t val) {
-    uint8_t temp[2];
-    stpmic_ret_t ret;
+    // --> load control registers now, responses must not read before writing.
+    for (uint8_t i = 0; in && i < STPMIC_OCP_RAILS && ret == STPMIC_RET_OK; ++i) {
+        const uint8_t reg = __stpmic_ocp_reg(i);
+        stpmic_reg_t val;
 
-    if ((ret = stpmic_read(STPMIC_REG_BUCKS_MRST_CR, &temp[0])) != STPMIC_RET_OK) {
-        return ret;
+        if (reg && (in->rails[i].action == STPMIC_OCP_DISABLE || in->rails[i].action == STPMIC_OCP_RETRY) &&
+            !__stpmic_cache_hit(ctx, reg))
+        {
+            ret = stpmic_ctx_read(ctx, (stpmic_regid_t) reg, &val);
+        }
     }
 
-    if ((ret = stpmic_read(STPMIC_REG_LDOS_MRST_CR, &temp[1])) != STPMIC_RET_OK) {
-        return ret;
+    if (ret == STPMIC_RET_OK && swoff && !__stpmic_cache_hit(ctx, STPMIC_REG_MAIN_CR)) {
+        stpmic_reg_t val;
+        ret = stpmic_ctx_read(ctx, STPMIC_REG_MAIN_CR, &val);
     }
 
-    temp[0] = (temp[0] & ~0x0f) | ((val >> 8) & 0x0f);
-    temp[1] = (temp[1] & ~0x7f) | ((val >> 0) & 0x7f);
-    
-    if ((ret = stpmic_write(STPMIC_REG_BUCKS_MRST_CR, temp[0])) != STPMIC_RET_OK) {
-        return ret;
+    if (in && ret == STPMIC_RET_OK) {
+        ctx->ocp.opts = *in;
+        ctx->ocp.enabled = 1;
     }
-    
-    return stpmic_write(STPMIC_REG_LDOS_MRST_CR, temp[1]);
+
+    STPMIC_UNLOCK(ctx);
+    return ret;
 }
 
-/* initialize the watchdog timer, sec: 1 ~ 255, 0: disable. */
-stpmic_ret_t stpmic_watchdog_init(uint8_t sec) {
-    if (sec == 0) {
-        return stpmic_watchdog_deinit();
+/* enable rails again whose backoff has elapsed. */
+stpmic_ret_t stpmic_ctx_ocp_poll(stpmic_ctx_t* ctx, uint32_t* next) {
+    stpmic_ret_t ret = STPMIC_RET_OK;
+    uint32_t now, wait = 0xffffffffu;
+
+    if (ctx->state < STPMIC_DRV_INIT) {
+        return STPMIC_RET_NODEV;
     }
 
-    /* 0x00 ~ 0xff = 1sec ~ 256sec. */
-    stpmic_ret_t ret = stpmic_write(STPMIC_REG_WDG_TMR_CR, sec - 1);
-    if (ret != STPMIC_RET_OK) {
-        return ret;
+    STPMIC_LOCK(ctx);
+    if (!ctx->ocp.enabled) {
+        STPMIC_UNLOCK(ctx);
+        return STPMIC_RET_DISABLED;
     }
 
-    uint8_t cr = (1u << 1) | (sec > 0 ? 0x01 : 0);
-    return stpmic_write_direct(STPMIC_REG_WDG_CR, cr);
-}
+    if (ctx->ocp.waiting && __stpmic_tick(ctx, &now)) {
+        for (uint8_t i = 0; i < STPMIC_OCP_RAILS; ++i) {
+            const uint16_t bit = (uint16_t)(1u << i);
+            const int32_t left = (int32_t)(ctx->ocp.due[i] - now);
 
+            if (!(ctx->ocp.waiting & bit)) {
+                continue;
+            }
 
-/* reset the watchdog counter to default counter. */
-stpmic_ret_t stpmic_watchdog_reset() {
-    stpmic_reg_t reg = 0;
-    stpmic_ret_t ret = stpmic_read(STPMIC_REG_WDG_TMR_CR, &reg);
-    if (ret != STPMIC_RET_OK) {
-        return ret;
+            if (left > 0) {
+                wait = (uint32_t) left < wait ? (uint32_t) left : wait;
+                continue;
+            }
+
+            if ((ret = __stpmic_ocp_switch(ctx, i, 1)) != STPMIC_RET_OK) {
+                break;
+            }
+
+            // --> `due` becomes the tick of the last retry.
+            ctx->ocp.waiting &= (uint16_t) ~bit;
+            ctx->ocp.due[i] = now;
+        }
     }
 
-    /* (MSB) RESV | RST(1) | ENA(1) (LSB). */
-    if ((reg & (1u << 0)) == 0) {
-        return STPMIC_RET_DISABLED;
+    STPMIC_UNLOCK(ctx);
+
+    if (next) {
+        *next = wait;
     }
 
-    return stpmic_write_direct(STPMIC_REG_WDG_CR, (1u << 1) | (1u << 0));
+    return ret;
 }
+#endif
 
-/* setup one of buck #1 ~ #4. */
-stpmic_ret_t __stpmic_buck_setup(uint8_t nth, uint8_t alt, stpmic_buck_t* opts) {
-    if (nth <= 0 || nth > 4) {
-        return STPMIC_RET_RANGE;
+#if STPMIC_IRQ_RING
+/* notify an assertion of INTn, from the interrupt handler. */
+stpmic_ret_t stpmic_ctx_irq_notify(stpmic_ctx_t* ctx, uint32_t stamp) {
+    const uint8_t head = ctx->irq.head;
+
+    if ((uint8_t)(head - ctx->irq.tail) >= STPMIC_IRQ_RING) {
+        ctx->irq.overflows++;
+        return STPMIC_RET_BUSY;
     }
 
-    stpmic_reg_t buckspd;
-    stpmic_ret_t ret = stpmic_buckspd(&buckspd);
-    if (ret != STPMIC_RET_OK) {
-        return ret;
+    ctx->irq.stamp[head & (STPMIC_IRQ_RING - 1)] = stamp;
+
+    // --> publish the entry before the index.
+    STPMIC_BARRIER();
+    ctx->irq.head = (uint8_t)(head + 1);
+    return STPMIC_RET_OK;
+}
+
+/* serve notifications of INTn, from the task context. */
+stpmic_ret_t stpmic_ctx_irq_service(
+    stpmic_ctx_t* ctx, const stpmic_irq_handler_t* handlers, void* arg, uint32_t* out)
+{
+    if (out) {
+        *out = 0;
     }
 
-    uint8_t val = (opts->volts << 2) & 0xfc;
-    if (!opts) {
+    if (!handlers) {
         return STPMIC_RET_INVALID;
     }
 
-    if (opts->mode) {
-        val |= STPMIC_BIT_MASK(1);
-    }
+    STPMIC_LOCK(ctx);
 
-    if (opts->enable) {
-        val |= STPMIC_BIT_MASK(0);
+    // --> entries up to `head` are complete once the index is seen.
+    const uint8_t head = ctx->irq.head;
+    const uint8_t tail = ctx->irq.tail;
+    STPMIC_BARRIER();
+
+    if (head == tail) {
+        STPMIC_UNLOCK(ctx);
+        return STPMIC_RET_OK;
     }
 
-    buckspd = stpmic_set_buckspd(buckspd, nth, opts->pd);
-    if ((ret = stpmic_write(STPMIC_REG_BUCKS_PD_CR, buckspd)) != STPMIC_RET_OK) {
-        return ret;
+    // --> pending flags are level state, a single dispatch serves all notifications.
+    const uint32_t since = ctx->irq.stamp[tail & (STPMIC_IRQ_RING - 1)];
+    stpmic_ret_t ret = __stpmic_interrupt_dispatch_locked(ctx, handlers, arg, out);
+
+    if (ret == STPMIC_RET_OK) {
+        ctx->irq.since = since;
+
+        // --> notifications pushed during the dispatch are kept for the next call.
+        STPMIC_BARRIER();
+        ctx->irq.tail = head;
     }
 
-    return stpmic_write(
-        (stpmic_regid_t)((
-            alt 
-            ? STPMIC_REG_BUCKx_ALT_CR 
-            : STPMIC_REG_BUCKx_MAIN_CR
-        ) + (nth - 1)),
-        val);
+    STPMIC_UNLOCK(ctx);
+    return ret;
 }
+#endif
 
-/**
- * enable the specified buck converter.
- * @param nth 1 ~ 4.
- * @return
- * `STPMIC_RET_NODEV` if STPMIC driver is not ready.
- * `STPMIC_RET_TIMEOUT` if timeout reached.
- * `STPMIC_RET_RANGE` if `nth` value is out of range.
- */
-stpmic_ret_t __stpmic_buck_enable(uint8_t nth, uint8_t alt) {
+/* test whether the NVM controller is busy or not. */
+stpmic_ret_t stpmic_ctx_nvm_is_busy(stpmic_ctx_t* ctx) {
     stpmic_reg_t reg;
-    stpmic_ret_t ret = alt
-        ? stpmic_buck_alt_cr(nth, &reg)
-        : stpmic_buck_main_cr(nth, &reg);
+    stpmic_ret_t ret = stpmic_ctx_read_direct(
+        ctx, STPMIC_REG_NVM_SR, &reg
+    );
 
     if (ret != STPMIC_RET_OK) {
         return ret;
     }
 
     if (reg & STPMIC_BIT_MASK(0)) {
-        return STPMIC_RET_ALREADY;
+        return STPMIC_RET_BUSY;
     }
 
-    reg |= STPMIC_BIT_MASK(0);
-    return stpmic_write(
-        (stpmic_regid_t)((
-            alt 
-            ? STPMIC_REG_BUCKx_ALT_CR 
-            : STPMIC_REG_BUCKx_MAIN_CR
-        ) + (nth - 1)),
-        reg);
+    return STPMIC_RET_OK;
 }
 
-/* disable the specified buck converter. */
-stpmic_ret_t __stpmic_buck_disable(uint8_t nth, uint8_t alt) {
-    stpmic_reg_t reg;
-    stpmic_ret_t ret = alt
-        ? stpmic_buck_alt_cr(nth, &reg)
-        : stpmic_buck_main_cr(nth, &reg);
+/* `stpmic_ctx_nvm_read` with the lock held. */
+static stpmic_ret_t __stpmic_nvm_read_locked(stpmic_ctx_t* ctx, stpmic_nvmregs_t* out) {
+    for (uint16_t i = 0; i < STPMIC_REG_NVM_COUNT; ++i) {
+        uint8_t reg = (uint8_t)(i + STPMIC_REG_NVM_MAIN_CTRL_SHR);
 
-    if (ret != STPMIC_RET_OK) {
-        return ret;
-    }
+        // --> read all of them at once on a miss, this caches them.
+        if (!__stpmic_cache_hit(ctx, reg)) {
+            stpmic_ret_t ret = stpmic_ctx_read_burst(
+                ctx, STPMIC_REG_NVM_MAIN_CTRL_SHR, out->regs, STPMIC_REG_NVM_COUNT);
 
-    if ((reg & STPMIC_BIT_MASK(0)) == 0) {
-        return STPMIC_RET_ALREADY;
+            if (ret != STPMIC_RET_OK) {
+                return ret;
+            }
+
+            break;
+        }
+
+        out->regs[i] = STPMIC_CACHE_VAL(ctx, reg);
     }
 
-    reg &= ~STPMIC_BIT_MASK(0);
-    return stpmic_write(
-        (stpmic_regid_t)((
-            alt 
-            ? STPMIC_REG_BUCKx_ALT_CR 
-            : STPMIC_REG_BUCKx_MAIN_CR
-        ) + (nth - 1)),
-        reg);
+    out->dirty = 0;
+    return STPMIC_RET_OK;
 }
 
-/* setup the specified LDO. */
-stpmic_ret_t __stpmic_ldo_setup(uint8_t nth, uint8_t alt, stpmic_ldo_t* opts) {
-    stpmic_reg_t ldo;
-    stpmic_reg_t reg;
+/* read NVM shadow registers. */
+stpmic_ret_t stpmic_ctx_nvm_read(stpmic_ctx_t* ctx, stpmic_nvmregs_t* out) {
+    STPMIC_LOCK(ctx);
+    stpmic_ret_t ret = __stpmic_nvm_read_locked(ctx, out);
+    STPMIC_UNLOCK(ctx);
+    return ret;
+}
+
+/* `stpmic_ctx_nvm_write` with the lock held. */
+static stpmic_ret_t __stpmic_nvm_write_locked(stpmic_ctx_t* ctx, stpmic_nvmregs_t* in) {
+    stpmic_regid_t cur_id;
     stpmic_ret_t ret;
 
-    if (nth >= 1 && nth <= 4) {
-        if ((ret = stpmic_ldo1234pd(&reg)) != STPMIC_RET_OK) {
-            return ret;
-        }
+    for (uint16_t i = 0; i < STPMIC_REG_NVM_COUNT; ++i) {
+        cur_id = (stpmic_reg_t)(i + STPMIC_REG_NVM_MAIN_CTRL_SHR);
 
-        reg = stpmic_set_ldo1234pd(reg, nth, opts->pd);
+        if ((in->dirty & (1u << i)) == 0) {
+            continue;
+        }
 
-        if ((ret = stpmic_write(STPMIC_REG_LDO1234_PD_CR, reg)) != STPMIC_RET_OK) {
+        if ((ret = stpmic_ctx_write_direct(ctx, cur_id, in->regs[i])) != STPMIC_RET_OK) {
             return ret;
         }
+
+        // --> clear dirty flags.
+        in->dirty &= ~(1u << i);
     }
 
-    else if (nth >= 5 && nth <= 6) {
-        if ((ret = stpmic_ldo56pd(&reg)) != STPMIC_RET_OK) {
-            return ret;
-        }
+    return STPMIC_RET_OK;
+}
 
-        reg = stpmic_set_ldo56pd(reg, nth, opts->pd);
+/* write NVM shadow registers. this does not program immediately. */
+stpmic_ret_t stpmic_ctx_nvm_write(stpmic_ctx_t* ctx, stpmic_nvmregs_t* in) {
+    STPMIC_LOCK(ctx);
+    stpmic_ret_t ret = __stpmic_nvm_write_locked(ctx, in);
+    STPMIC_UNLOCK(ctx);
+    return ret;
+}
 
-        if ((ret = stpmic_write(STPMIC_REG_LDO56_VREF_PD_CR, reg)) != STPMIC_RET_OK) {
+/* wait the NVM controller to be not busy. */
+stpmic_ret_t stpmic_ctx_nvm_wait(stpmic_ctx_t* ctx) {
+    stpmic_ret_t ret;
+    
+    while ((ret = stpmic_ctx_nvm_is_busy(ctx)) != STPMIC_RET_OK) {
+        if (ret != STPMIC_RET_BUSY) {
             return ret;
         }
     }
 
-    else {
-        return STPMIC_RET_RANGE;
+    return STPMIC_RET_OK;
+}
+
+/* `stpmic_ctx_nvm_program` with the lock held. */
+static stpmic_ret_t __stpmic_nvm_program_locked(stpmic_ctx_t* ctx) {
+    stpmic_ret_t ret = stpmic_ctx_nvm_wait(ctx);
+    
+    if (ret != STPMIC_RET_OK) {
+        return ret;
     }
 
-    if (alt) {
-        ldo = (stpmic_reg_t)(STPMIC_REG_LDOx_ALT_CR + (nth - 1));
-    } else {
-        ldo = (stpmic_reg_t)(STPMIC_REG_LDOx_MAIN_CR + (nth - 1));
+    if ((ret = stpmic_ctx_nvm_exec_cmd(ctx, STPMIC_NVMCMD_PROGRAM)) != STPMIC_RET_OK) {
+        return ret;
     }
 
-    uint8_t val = 0;
-    switch (nth) {
-        case 1: case 2: case 5: case 6: {
-            val = (opts->volts & 0x1f) << 2;
+    return stpmic_ctx_nvm_wait(ctx);
+}
 
-            if (opts->enable) {
-                val |= STPMIC_BIT_MASK(0);
-            }
-            break;
-        }
+/* program the NVM once. */
+stpmic_ret_t stpmic_ctx_nvm_program(stpmic_ctx_t* ctx) {
+    STPMIC_LOCK(ctx);
+    stpmic_ret_t ret = __stpmic_nvm_program_locked(ctx);
+    STPMIC_UNLOCK(ctx);
+    return ret;
+}
 
-        case 3: {
-            val = (opts->volts & 0x1f) << 2;
+/* `stpmic_ctx_nvm_reload` with the lock held. */
+static stpmic_ret_t __stpmic_nvm_reload_locked(stpmic_ctx_t* ctx) {
+    stpmic_ret_t ret = stpmic_ctx_nvm_wait(ctx);
+    
+    if (ret != STPMIC_RET_OK) {
+        return ret;
+    }
 
-            if (opts->bypass) {
-                val |= STPMIC_BIT_MASK(7);
-            }
+    if ((ret = stpmic_ctx_nvm_exec_cmd(ctx, STPMIC_NVMCMD_READ)) != STPMIC_RET_OK) {
+        return ret;
+    }
 
-            if (opts->enable) {
-                val |= STPMIC_BIT_MASK(0);
-            }
-            break;
-        }
-        case 4: {
-            switch (opts->src) {
-                case STPMIC_LDO4SRC_VIN:
-                    val |= STPMIC_BIT_MASK(2);
-                    break;
+    return stpmic_ctx_nvm_wait(ctx);
+}
 
-                case STPMIC_LDO4SRC_BSTOUT:
-                    val |= STPMIC_BIT_MASK(3);
-                    break;
+/* reload the NVM once. this discards all shadow register changes in STPMIC. */
+stpmic_ret_t stpmic_ctx_nvm_reload(stpmic_ctx_t* ctx) {
+    STPMIC_LOCK(ctx);
+    stpmic_ret_t ret = __stpmic_nvm_reload_locked(ctx);
+    STPMIC_UNLOCK(ctx);
+    return ret;
+}
 
-                case STPMIC_LDO4SRC_VBUSOTG:
-                    val |= STPMIC_BIT_MASK(4);
-                    break;
-                
-                case STPMIC_LDO4SRC_UNKNOWN: // --> automatic for all bits.
-                default:
-                    break;
-            }
+/* program the NVM once, within the budget. */
+stpmic_ret_t stpmic_ctx_nvm_program_within(stpmic_ctx_t* ctx, uint32_t budget, stpmic_progress_t* out) {
+    return __stpmic_within(ctx, stpmic_ctx_nvm_program, budget, out);
+}
 
-            if (opts->src != STPMIC_LDO4SRC_OFF &&
-                opts->enable) 
-            {
-                val |= STPMIC_BIT_MASK(0);
-            }
-            break;
-        }
+/* reload the NVM once, within the budget. */
+stpmic_ret_t stpmic_ctx_nvm_reload_within(stpmic_ctx_t* ctx, uint32_t budget, stpmic_progress_t* out) {
+    return __stpmic_within(ctx, stpmic_ctx_nvm_reload, budget, out);
+}
 
-        default:
-            return STPMIC_RET_RANGE;
+// --> rejected with STPMIC_USE_LINUX by `stpmic.h`, only its `#error` is reported.
+#if STPMIC_USE_ASYNC && !STPMIC_USE_LINUX
+/* start the current step of asynchronous operation. */
+static stpmic_ret_t __stpmic_async_kick(stpmic_ctx_t* ctx) {
+    stpmic_async_step_t* step = &ctx->async.steps[ctx->async.step];
+
+    if (!step->rw) {
+        STPMIC_RETAIN_HOLD(ctx);
     }
 
-    return stpmic_write(ldo, val);
-}
+#if STPMIC_USE_HAL
+    HAL_StatusTypeDef ret;
+
+    if (step->rw) {
+        ret = STPMIC_HAL_READ_ASYNC(
+            ctx->dev, (ctx->addr << 1) | 0, step->reg,
+            I2C_MEMADD_SIZE_8BIT, step->buf, step->len);
+    }
 
-/* enable the specified LDO. */
-stpmic_ret_t __stpmic_ldo_enable(uint8_t nth, uint8_t alt) {
-    if (nth <= 0 || nth > 6) {
-        return STPMIC_RET_RANGE;
+    else {
+        ret = STPMIC_HAL_WRITE_ASYNC(
+            ctx->dev, (ctx->addr << 1) | 0, step->reg,
+            I2C_MEMADD_SIZE_8BIT, step->buf, step->len);
     }
 
-    stpmic_reg_t reg;
-    stpmic_regid_t ldo = (stpmic_reg_t)((
-        alt ? STPMIC_REG_LDOx_ALT_CR : STPMIC_REG_LDOx_MAIN_CR
-    ) + (nth - 1));
+    if (ret == HAL_BUSY) {
+        return STPMIC_RET_BUSY;
+    }
 
-    stpmic_ret_t ret = stpmic_read(ldo, &reg);
-    if (ret != STPMIC_RET_OK) {
-        return ret;
+    if (ret != HAL_OK) {
+        return STPMIC_RET_TIMEOUT;
+    }
+#elif STPMIC_USE_CUSTOM
+    if (!stpmic_xfer_async_i2c(
+        (ctx->addr << 1) | 0, step->reg,
+        step->buf, step->len, step->rw))
+    {
+        return STPMIC_RET_TIMEOUT;
+    }
+#else
+    if (!ctx->dev->xfer_async) {
+        return STPMIC_RET_NOTSUP;
     }
 
-    if (reg & STPMIC_BIT_MASK(0)) {
-        return STPMIC_RET_ALREADY;
+    if (!ctx->dev->xfer_async(
+        ctx->dev, (ctx->addr << 1) | 0, step->reg,
+        step->buf, step->len, step->rw))
+    {
+        return STPMIC_RET_TIMEOUT;
     }
+#endif
 
-    reg |= STPMIC_BIT_MASK(0);
-    return stpmic_write(ldo, reg);
+    return STPMIC_RET_OK;
 }
 
-/* disable the specified LDO. */
-stpmic_ret_t __stpmic_ldo_disable(uint8_t nth, uint8_t alt) {
-    if (nth <= 0 || nth > 6) {
-        return STPMIC_RET_RANGE;
+/* finish the asynchronous operation, then call the callback. */
+static void __stpmic_async_finish(stpmic_ctx_t* ctx, stpmic_ret_t ret) {
+    stpmic_async_cb_t cb = ctx->async.cb;
+    void* arg = ctx->async.arg;
+
+    if (ret == STPMIC_RET_OK) {
+        ret = ctx->async.result;
     }
 
-    stpmic_reg_t reg;
-    stpmic_regid_t ldo = (stpmic_reg_t)((
-        alt ? STPMIC_REG_LDOx_ALT_CR : STPMIC_REG_LDOx_MAIN_CR
-    ) + (nth - 1));
+    ctx->async.busy = 0;
 
-    stpmic_ret_t ret = stpmic_read(ldo, &reg);
+    if (cb) {
+        cb(ret, arg);
+    }
+}
 
-    if (ret != STPMIC_RET_OK) {
-        return ret;
+/* begin an asynchronous operation. */
+static stpmic_ret_t __stpmic_async_begin(stpmic_ctx_t* ctx, stpmic_async_cb_t cb, void* arg) {
+    if (ctx->state < STPMIC_DRV_READY) {
+        return STPMIC_RET_NODEV;
     }
 
-    if ((reg & STPMIC_BIT_MASK(0)) == 0) {
-        return STPMIC_RET_ALREADY;
+    // --> synchronous APIs hold the lock while they own the bus.
+    STPMIC_LOCK(ctx);
+    if (ctx->async.busy) {
+        STPMIC_UNLOCK(ctx);
+        return STPMIC_RET_BUSY;
     }
 
-    reg &= ~STPMIC_BIT_MASK(0);
-    return stpmic_write(ldo, reg);
-}
+    ctx->async.busy = 1;
+    STPMIC_UNLOCK(ctx);
 
-/* enable the REFDDR. */
-stpmic_ret_t __stpmic_refddr_enable(uint8_t alt) {
-    stpmic_reg_t reg;
-    stpmic_ret_t ret = stpmic_read((
-        alt ? STPMIC_REG_REFDDR_ALT_CR : STPMIC_REG_REFDDR_MAIN_CR
-    ), &reg);
+    ctx->async.step = 0;
+    ctx->async.count = 0;
+    ctx->async.next = NULL;
+    ctx->async.result = STPMIC_RET_OK;
+    ctx->async.cb = cb;
+    ctx->async.arg = arg;
+    ctx->async.out32 = NULL;
+    return STPMIC_RET_OK;
+}
 
-    if (ret != STPMIC_RET_OK) {
-        return ret;
-    }
+/* queue a read step. */
+static stpmic_async_step_t* __stpmic_async_read(stpmic_ctx_t* ctx, uint8_t reg, stpmic_reg_t* out, uint8_t len) {
+    stpmic_async_step_t* step = &ctx->async.steps[ctx->async.count++];
 
-    reg |= STPMIC_BIT_MASK(0);
-    return stpmic_write((
-        alt ? STPMIC_REG_REFDDR_ALT_CR : STPMIC_REG_REFDDR_MAIN_CR
-    ), reg);
+    step->reg = reg;
+    step->len = len;
+    step->rw = 1;
+    step->out = out;
+    return step;
 }
 
-/* disable the REFDDR. */
-stpmic_ret_t __stpmic_refddr_disable(uint8_t alt) {
-    stpmic_reg_t reg;
-    stpmic_ret_t ret = stpmic_read((
-        alt ? STPMIC_REG_REFDDR_ALT_CR : STPMIC_REG_REFDDR_MAIN_CR
-    ), &reg);
+/* queue a write step, adjacent writes are merged, unchanged cached values are skipped. */
+static void __stpmic_async_write(stpmic_ctx_t* ctx, uint8_t reg, stpmic_reg_t val) {
+    if (__stpmic_cache_hit(ctx, reg) && !STPMIC_IS_DIRTY(ctx, reg) &&
+        STPMIC_CACHE_VAL(ctx, reg) == val)
+    {
+        return;
+    }
 
-    if (ret != STPMIC_RET_OK) {
-        return ret;
+    if (ctx->async.count > 0) {
+        stpmic_async_step_t* last = &ctx->async.steps[ctx->async.count - 1];
+
+        if (!last->rw && last->len < STPMIC_BURST_MAX && last->reg + last->len == reg) {
+            last->buf[last->len++] = val;
+            return;
+        }
     }
 
-    reg &= ~STPMIC_BIT_MASK(0);
-    return stpmic_write((
-        alt ? STPMIC_REG_REFDDR_ALT_CR : STPMIC_REG_REFDDR_MAIN_CR
-    ), reg);
+    stpmic_async_step_t* step = &ctx->async.steps[ctx->async.count++];
+
+    step->reg = reg;
+    step->len = 1;
+    step->rw = 0;
+    step->out = NULL;
+    step->buf[0] = val;
 }
 
-/* read `INT_PENDING_Rx` register. */
-stpmic_ret_t stpmic_interrupt_pending(uint32_t* out) {
-    uint32_t val = 0;
+/* start the queued asynchronous operation. */
+static stpmic_ret_t __stpmic_async_start(stpmic_ctx_t* ctx) {
+    stpmic_ret_t ret = STPMIC_RET_OK;
 
-    for (
-        uint8_t i = STPMIC_REG_INT_PENDING_R1;
-         i < STPMIC_REG_INT_PENDING_R4; ++i) 
-    {
-        stpmic_reg_t reg;
-        stpmic_ret_t ret = stpmic_read((stpmic_regid_t)i, &reg);
+    // --> everything is cached: compose writes immediately.
+    if (ctx->async.count == 0 && ctx->async.next) {
+        stpmic_ret_t (*next)(stpmic_ctx_t*) = ctx->async.next;
 
-        if (ret != STPMIC_RET_OK) {
-            return ret;
-        }
+        ctx->async.next = NULL;
+        ret = next(ctx);
+    }
 
-        val |= ((uint32_t)reg) << (i << 3);
+    if (ret != STPMIC_RET_OK) {
+        ctx->async.busy = 0;
+        return ret;
     }
 
-    if (out) {
-        *out = val;
+    // --> nothing to transfer.
+    if (ctx->async.count == 0) {
+        __stpmic_async_finish(ctx, STPMIC_RET_OK);
+        return STPMIC_RET_OK;
     }
 
-    return STPMIC_RET_OK;
+    if ((ret = __stpmic_async_kick(ctx)) != STPMIC_RET_OK) {
+        ctx->async.busy = 0;
+    }
+
+    return ret;
 }
 
-/* clear interrupts. */
-stpmic_ret_t stpmic_interrupt_clear(uint32_t bitmap) {
-    for (
-        uint8_t i = STPMIC_REG_INT_CLEAR_R1;
-         i < STPMIC_REG_INT_CLEAR_R4; ++i) 
-    {
-        const uint8_t u8 = bitmap >> (i << 3);
-        if (u8 == 0) {
-            continue;
+/* notify the completion of the current asynchronous transfer. */
+void stpmic_ctx_async_complete(stpmic_ctx_t* ctx, stpmic_ret_t ret) {
+    if (!ctx->async.busy) {
+        return;
+    }
+
+    if (ret == STPMIC_RET_OK) {
+        stpmic_async_step_t* step = &ctx->async.steps[ctx->async.step++];
+
+        // --> serialized with writers of the cache, readers retry on the sequence counter.
+        STPMIC_LOCK(ctx);
+        __stpmic_cache_store(ctx, step->reg, step->buf, step->len, !step->rw);
+        STPMIC_UNLOCK(ctx);
+
+        if (step->rw && step->out) {
+            memcpy(step->out, step->buf, step->len);
         }
 
-        stpmic_ret_t ret = stpmic_write((stpmic_regid_t)i, u8);
+        // --> all queued steps are done, compose more.
+        if (ctx->async.step >= ctx->async.count && ctx->async.next) {
+            stpmic_ret_t (*next)(stpmic_ctx_t*) = ctx->async.next;
 
-        if (ret != STPMIC_RET_OK) {
-            return ret;
+            ctx->async.step = 0;
+            ctx->async.count = 0;
+            ctx->async.next = NULL;
+            ret = next(ctx);
+        }
+
+        if (ret == STPMIC_RET_OK && ctx->async.step < ctx->async.count) {
+            if ((ret = __stpmic_async_kick(ctx)) == STPMIC_RET_OK) {
+                return;
+            }
         }
     }
 
-    return STPMIC_RET_OK;
+    __stpmic_async_finish(ctx, ret);
 }
 
-/* mask an interrupt. */
-stpmic_ret_t stpmic_interrupt_read_mask(uint32_t* out) {
-    uint32_t val = 0;
+/* test whether an asynchronous operation is in flight or not. */
+uint8_t stpmic_ctx_async_busy(stpmic_ctx_t* ctx) {
+    return ctx->async.busy;
+}
 
-    for (
-        uint8_t i = STPMIC_REG_INT_MASK_R1;
-         i < STPMIC_REG_INT_MASK_R4; ++i) 
-    {
-        stpmic_reg_t reg;
-        stpmic_ret_t ret = stpmic_read((stpmic_regid_t)i, &reg);
+/* read a register of STPMIC with cache, asynchronously. */
+stpmic_ret_t stpmic_ctx_read_async(stpmic_ctx_t* ctx, stpmic_regid_t reg, stpmic_reg_t* out, stpmic_async_cb_t cb, void* arg) {
+    if (reg >= STPMIC_REG_MAX) {
+        return STPMIC_RET_INVALID;
+    }
 
-        if (ret != STPMIC_RET_OK) {
-            return ret;
-        }
+    stpmic_ret_t ret = __stpmic_async_begin(ctx, cb, arg);
+    if (ret != STPMIC_RET_OK) {
+        return ret;
+    }
 
-        val |= ((uint32_t)reg) << (i << 3);
+    if (__stpmic_cache_hit(ctx, reg)) {
+        if (out) {
+            *out = STPMIC_CACHE_VAL(ctx, reg);
+        }
     }
 
-    if (out) {
-        *out = val;
+    else {
+        __stpmic_async_read(ctx, reg, out, 1);
     }
 
-    return STPMIC_RET_OK;
+    return __stpmic_async_start(ctx);
 }
 
-/* set interrupt masks. */
-stpmic_ret_t stpmic_interrupt_mask_set(uint32_t bitmap) {
-    for (
-        uint8_t i = STPMIC_REG_INT_MASK_SET_R1;
-         i < STPMIC_REG_INT_MASK_SET_R4; ++i) 
-    {
-        const uint8_t u8 = bitmap >> (i << 3);
-        if (u8 == 0) {
-            continue;
-        }
+/* write a register of STPMIC with cache, asynchronously. */
+stpmic_ret_t stpmic_ctx_write_async(stpmic_ctx_t* ctx, stpmic_regid_t reg, stpmic_reg_t val, stpmic_async_cb_t cb, void* arg) {
+    if (reg >= STPMIC_REG_MAX) {
+        return STPMIC_RET_INVALID;
+    }
 
-        stpmic_ret_t ret = stpmic_write((stpmic_regid_t)i, u8);
+    if (STPMIC_REGATTR[reg] & STPMIC_REGATTR_RO) {
+        return STPMIC_RET_NOTSUP;
+    }
 
-        if (ret != STPMIC_RET_OK) {
-            return ret;
-        }
+    stpmic_ret_t ret = __stpmic_async_begin(ctx, cb, arg);
+    if (ret != STPMIC_RET_OK) {
+        return ret;
     }
 
-    return STPMIC_RET_OK;
+    __stpmic_async_write(ctx, reg, val);
+    return __stpmic_async_start(ctx);
 }
 
-/* clear interrupt masks. */
-stpmic_ret_t stpmic_interrupt_mask_clear(uint32_t bitmap) {
-    for (
-        uint8_t i = STPMIC_REG_INT_MASK_CLEAR_R1;
-         i < STPMIC_REG_INT_MASK_CLEAR_R4; ++i) 
-    {
-        const uint8_t u8 = bitmap >> (i << 3);
-        if (u8 == 0) {
-            continue;
-        }
+/* read contiguous registers of STPMIC without cache, asynchronously. */
+stpmic_ret_t stpmic_ctx_read_burst_async(stpmic_ctx_t* ctx, stpmic_regid_t reg, stpmic_reg_t* out, uint8_t len, stpmic_async_cb_t cb, void* arg) {
+    if (!out || !len || len > STPMIC_BURST_MAX || ((uint32_t)reg) + len > STPMIC_REG_MAX) {
+        return STPMIC_RET_INVALID;
+    }
 
-        stpmic_ret_t ret = stpmic_write((stpmic_regid_t)i, u8);
+    stpmic_ret_t ret = __stpmic_async_begin(ctx, cb, arg);
+    if (ret != STPMIC_RET_OK) {
+        return ret;
+    }
 
-        if (ret != STPMIC_RET_OK) {
-            return ret;
-        }
+    __stpmic_async_read(ctx, reg, out, len);
+    return __stpmic_async_start(ctx);
+}
+
+/* write contiguous registers of STPMIC without cache, asynchronously. */
+stpmic_ret_t stpmic_ctx_write_burst_async(stpmic_ctx_t* ctx, stpmic_regid_t reg, const stpmic_reg_t* in, uint8_t len, stpmic_async_cb_t cb, void* arg) {
+    if (!in || !len || len > STPMIC_BURST_MAX || ((uint32_t)reg) + len > STPMIC_REG_MAX) {
+        return STPMIC_RET_INVALID;
     }
 
-    return STPMIC_RET_OK;
+    stpmic_ret_t ret = __stpmic_async_begin(ctx, cb, arg);
+    if (ret != STPMIC_RET_OK) {
+        return ret;
+    }
+
+    stpmic_async_step_t* step = &ctx->async.steps[ctx->async.count++];
+
+    step->reg = reg;
+    step->len = len;
+    step->rw = 0;
+    step->out = NULL;
+    memcpy(step->buf, in, len);
+    return __stpmic_async_start(ctx);
 }
 
-/* read interrupt sources. */
-stpmic_ret_t stpmic_interrupt_read_source(uint32_t* out) {
-    uint32_t val = 0;
+/* compose writes of buck setup after the PD register is cached. */
+static stpmic_ret_t __stpmic_buck_setup_next(stpmic_ctx_t* ctx) {
+    stpmic_reg_t buckspd = STPMIC_CACHE_VAL(ctx, STPMIC_REG_BUCKS_PD_CR);
 
-    for (
-        uint8_t i = STPMIC_REG_INT_SRC_R1;
-         i < STPMIC_REG_INT_SRC_R4; ++i) 
-    {
-        stpmic_reg_t reg;
-        stpmic_ret_t ret = stpmic_read((stpmic_regid_t)i, &reg);
+    buckspd = stpmic_set_buckspd(buckspd, ctx->async.nth, (stpmic_buckspd_t) ctx->async.pd);
+    __stpmic_async_write(ctx, STPMIC_REG_BUCKS_PD_CR, buckspd);
+    __stpmic_async_write(ctx, ctx->async.reg, ctx->async.val);
+    return STPMIC_RET_OK;
+}
 
-        if (ret != STPMIC_RET_OK) {
-            return ret;
-        }
+/* setup one of buck #1 ~ #4, asynchronously. */
+stpmic_ret_t __stpmic_ctx_buck_setup_async(stpmic_ctx_t* ctx, uint8_t nth, uint8_t alt, stpmic_buck_t* opts, stpmic_async_cb_t cb, void* arg) {
+    if (nth <= 0 || nth > 4) {
+        return STPMIC_RET_RANGE;
+    }
 
-        val |= ((uint32_t)reg) << (i << 3);
+    if (!opts) {
+        return STPMIC_RET_INVALID;
     }
 
-    if (out) {
-        *out = val;
+    stpmic_ret_t ret = __stpmic_async_begin(ctx, cb, arg);
+    if (ret != STPMIC_RET_OK) {
+        return ret;
     }
 
-    return STPMIC_RET_OK;
-}
+    ctx->async.nth = nth;
+    ctx->async.pd = opts->pd;
+    ctx->async.val = __stpmic_buck_value(opts);
+    ctx->async.reg = (alt ? STPMIC_REG_BUCKx_ALT_CR : STPMIC_REG_BUCKx_MAIN_CR) + (nth - 1);
+    ctx->async.next = __stpmic_buck_setup_next;
 
-/* write interrupt sources. */
-stpmic_ret_t stpmic_interrupt_write_source(uint32_t bitmap) {
-    for (
-        uint8_t i = STPMIC_REG_INT_SRC_R1;
-         i < STPMIC_REG_INT_SRC_R4; ++i) 
-    {
-        const uint8_t u8 = bitmap >> (i << 3);
-        if (u8 == 0) {
-            continue;
-        }
+    if (!__stpmic_cache_hit(ctx, STPMIC_REG_BUCKS_PD_CR)) {
+        __stpmic_async_read(ctx, STPMIC_REG_BUCKS_PD_CR, NULL, 1);
+    }
 
-        stpmic_ret_t ret = stpmic_write((stpmic_regid_t)i, u8);
+    return __stpmic_async_start(ctx);
+}
 
-        if (ret != STPMIC_RET_OK) {
-            return ret;
-        }
+/* compose writes of LDO setup after the PD register is cached. */
+static stpmic_ret_t __stpmic_ldo_setup_next(stpmic_ctx_t* ctx) {
+    uint8_t nth = ctx->async.nth;
+    uint8_t pdreg = nth <= 4 ? STPMIC_REG_LDO1234_PD_CR : STPMIC_REG_LDO56_VREF_PD_CR;
+    stpmic_reg_t pd = STPMIC_CACHE_VAL(ctx, pdreg);
+
+    if (nth <= 4) {
+        pd = stpmic_set_ldo1234pd(pd, nth, (stpmic_ldospd_t) ctx->async.pd);
+    } else {
+        pd = stpmic_set_ldo56pd(pd, nth, (stpmic_ldospd_t) ctx->async.pd);
     }
 
+    __stpmic_async_write(ctx, pdreg, pd);
+    __stpmic_async_write(ctx, ctx->async.reg, ctx->async.val);
     return STPMIC_RET_OK;
 }
 
-/* test whether the NVM controller is busy or not. */
-stpmic_ret_t stpmic_nvm_is_busy() {
-    stpmic_reg_t reg;
-    stpmic_ret_t ret = stpmic_read_direct(
-        STPMIC_REG_NVM_SR, &reg
-    );
+/* setup the specified LDO, asynchronously. */
+stpmic_ret_t __stpmic_ctx_ldo_setup_async(stpmic_ctx_t* ctx, uint8_t nth, uint8_t alt, stpmic_ldo_t* opts, stpmic_async_cb_t cb, void* arg) {
+    if (!opts) {
+        return STPMIC_RET_INVALID;
+    }
 
+    uint8_t val;
+    stpmic_ret_t ret = __stpmic_ldo_value(nth, opts, &val);
     if (ret != STPMIC_RET_OK) {
         return ret;
     }
 
-    if (reg & STPMIC_BIT_MASK(0)) {
-        return STPMIC_RET_BUSY;
+    if ((ret = __stpmic_async_begin(ctx, cb, arg)) != STPMIC_RET_OK) {
+        return ret;
     }
 
-    return STPMIC_RET_OK;
+    ctx->async.nth = nth;
+    ctx->async.pd = opts->pd;
+    ctx->async.val = val;
+    ctx->async.reg = (alt ? STPMIC_REG_LDOx_ALT_CR : STPMIC_REG_LDOx_MAIN_CR) + (nth - 1);
+    ctx->async.next = __stpmic_ldo_setup_next;
+
+    uint8_t pdreg = nth <= 4 ? STPMIC_REG_LDO1234_PD_CR : STPMIC_REG_LDO56_VREF_PD_CR;
+    if (!__stpmic_cache_hit(ctx, pdreg)) {
+        __stpmic_async_read(ctx, pdreg, NULL, 1);
+    }
+
+    return __stpmic_async_start(ctx);
 }
 
-/* read NVM shadow registers. */
-stpmic_ret_t stpmic_nvm_read(stpmic_nvmregs_t* out) {
-    stpmic_regid_t cur_id;
-    stpmic_ret_t ret;
-    stpmic_reg_t regs[STPMIC_REG_NVM_COUNT];
+/* compose the write of the ENA bit after the register is cached. */
+static stpmic_ret_t __stpmic_enable_next(stpmic_ctx_t* ctx) {
+    stpmic_reg_t reg = STPMIC_CACHE_VAL(ctx, ctx->async.reg);
+    stpmic_reg_t val = (reg & ~ctx->async.mask) | ctx->async.val;
 
-    for (uint16_t i = 0; i < STPMIC_REG_NVM_COUNT; ++i) {
-        cur_id = (stpmic_reg_t)(i + STPMIC_REG_NVM_MAIN_CTRL_SHR);
-        
-        if ((ret = stpmic_read_direct(cur_id, &out->regs[i])) != STPMIC_RET_OK) {
-            return ret;
-        }
+    if (val == reg) {
+        ctx->async.result = STPMIC_RET_ALREADY;
+        return STPMIC_RET_OK;
     }
 
-    out->dirty = 0;
+    __stpmic_async_write(ctx, ctx->async.reg, val);
     return STPMIC_RET_OK;
 }
 
-/* write NVM shadow registers. this does not program immediately. */
-stpmic_ret_t stpmic_nvm_write(stpmic_nvmregs_t* in) {
-    stpmic_regid_t cur_id;
-    stpmic_ret_t ret;
-    stpmic_reg_t regs[STPMIC_REG_NVM_COUNT];
+/* set or clear the ENA bit of the register, asynchronously. */
+static stpmic_ret_t __stpmic_enable_async(stpmic_ctx_t* ctx, uint8_t reg, uint8_t enable, stpmic_async_cb_t cb, void* arg) {
+    stpmic_ret_t ret = __stpmic_async_begin(ctx, cb, arg);
+    if (ret != STPMIC_RET_OK) {
+        return ret;
+    }
 
-    for (uint16_t i = 0; i < STPMIC_REG_NVM_COUNT; ++i) {
-        cur_id = (stpmic_reg_t)(i + STPMIC_REG_NVM_MAIN_CTRL_SHR);
+    ctx->async.reg = reg;
+    ctx->async.mask = STPMIC_BIT_MASK(0);
+    ctx->async.val = enable ? STPMIC_BIT_MASK(0) : 0;
+    ctx->async.next = __stpmic_enable_next;
 
-        if ((in->dirty & (1u << i)) == 0) {
-            continue;
-        }
+    if (!__stpmic_cache_hit(ctx, reg)) {
+        __stpmic_async_read(ctx, reg, NULL, 1);
+    }
 
-        if ((ret = stpmic_write_direct(cur_id, in->regs[i])) != STPMIC_RET_OK) {
-            return ret;
-        }
+    return __stpmic_async_start(ctx);
+}
 
-        // --> clear dirty flags.
-        in->dirty &= ~(1u << i);
+/* enable or disable the specified buck converter, asynchronously. */
+stpmic_ret_t __stpmic_ctx_buck_enable_async(stpmic_ctx_t* ctx, uint8_t nth, uint8_t alt, uint8_t enable, stpmic_async_cb_t cb, void* arg) {
+    if (nth <= 0 || nth > 4) {
+        return STPMIC_RET_RANGE;
     }
 
-    return STPMIC_RET_OK;
+    return __stpmic_enable_async(
+        ctx, (alt ? STPMIC_REG_BUCKx_ALT_CR : STPMIC_REG_BUCKx_MAIN_CR) + (nth - 1),
+        enable, cb, arg);
 }
 
-/* wait the NVM controller to be not busy. */
-stpmic_ret_t stpmic_nvm_wait() {
-    stpmic_ret_t ret;
-    
-    while ((ret = stpmic_nvm_is_busy()) != STPMIC_RET_OK) {
-        if (ret != STPMIC_RET_BUSY) {
-            return ret;
-        }
+/* enable or disable the specified LDO, asynchronously. */
+stpmic_ret_t __stpmic_ctx_ldo_enable_async(stpmic_ctx_t* ctx, uint8_t nth, uint8_t alt, uint8_t enable, stpmic_async_cb_t cb, void* arg) {
+    if (nth <= 0 || nth > 6) {
+        return STPMIC_RET_RANGE;
     }
 
-    return STPMIC_RET_OK;
+    return __stpmic_enable_async(
+        ctx, (alt ? STPMIC_REG_LDOx_ALT_CR : STPMIC_REG_LDOx_MAIN_CR) + (nth - 1),
+        enable, cb, arg);
 }
 
-/* program the NVM once. */
-stpmic_ret_t stpmic_nvm_program() {
-    stpmic_ret_t ret = stpmic_nvm_wait();
-    
-    if (ret != STPMIC_RET_OK) {
-        return ret;
+/* assemble `INT_PENDING_Rx` registers. */
+static stpmic_ret_t __stpmic_interrupt_pending_next(stpmic_ctx_t* ctx) {
+    uint32_t val = 0;
+
+    for (uint8_t i = 0; i < 4; ++i) {
+        val |= ((uint32_t) ctx->async.temp[i]) << (i << 3);
     }
 
-    if ((ret = stpmic_nvm_exec_cmd(STPMIC_NVMCMD_PROGRAM)) != STPMIC_RET_OK) {
-        return ret;
+    if (ctx->async.out32) {
+        *ctx->async.out32 = val;
     }
 
-    return stpmic_nvm_wait();
+    return STPMIC_RET_OK;
 }
 
-/* reload the NVM once. this discards all shadow register changes in STPMIC. */
-stpmic_ret_t stpmic_nvm_reload() {
-    stpmic_ret_t ret = stpmic_nvm_wait();
-    
+/* read `INT_PENDING_Rx` registers, asynchronously. */
+stpmic_ret_t stpmic_ctx_interrupt_pending_async(stpmic_ctx_t* ctx, uint32_t* out, stpmic_async_cb_t cb, void* arg) {
+    stpmic_ret_t ret = __stpmic_async_begin(ctx, cb, arg);
     if (ret != STPMIC_RET_OK) {
         return ret;
     }
 
-    if ((ret = stpmic_nvm_exec_cmd(STPMIC_NVMCMD_READ)) != STPMIC_RET_OK) {
+    ctx->async.out32 = out;
+    ctx->async.next = __stpmic_interrupt_pending_next;
+    __stpmic_async_read(ctx, STPMIC_REG_INT_PENDING_R1, ctx->async.temp, 4);
+    return __stpmic_async_start(ctx);
+}
+
+/* clear interrupts, asynchronously. */
+stpmic_ret_t stpmic_ctx_interrupt_clear_async(stpmic_ctx_t* ctx, uint32_t bitmap, stpmic_async_cb_t cb, void* arg) {
+    stpmic_ret_t ret = __stpmic_async_begin(ctx, cb, arg);
+    if (ret != STPMIC_RET_OK) {
         return ret;
     }
 
-    return stpmic_nvm_wait();
-}
\ No newline at end of file
+    if (bitmap) {
+        uint8_t s = 0, e = 3;
+        stpmic_async_step_t* step = &ctx->async.steps[ctx->async.count++];
+
+        // --> write only the span of non-zero bytes.
+        while (((bitmap >> (s << 3)) & 0xffu) == 0) s++;
+        while (((bitmap >> (e << 3)) & 0xffu) == 0) e--;
+
+        step->reg = STPMIC_REG_INT_CLEAR_R1 + s;
+        step->len = e - s + 1;
+        step->rw = 0;
+        step->out = NULL;
+
+        for (uint8_t i = s; i <= e; ++i) {
+            step->buf[i - s] = (uint8_t)(bitmap >> (i << 3));
+        }
+    }
+
+    return __stpmic_async_start(ctx);
+}
+#endif
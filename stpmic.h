@@ -29,6 +29,12 @@
  *      uint8_t (*write_i2c)(
  *          struct stpmic_i2c_t*, uint8_t addr,
  *          uint8_t* buf, uint32_t len, uint32_t timeout);
+ *      uint8_t (*read_reg_i2c)(    // --> optional, can be NULL.
+ *          struct stpmic_i2c_t*, uint8_t addr, uint8_t reg,
+ *          uint8_t* buf, uint32_t len, uint32_t timeout);
+ *      ...
+ *      uint32_t (*get_tick)(       // --> optional, can be NULL.
+ *          struct stpmic_i2c_t*);
  *  } stpmic_i2c_t;
  * 
  * 3. STPMIC_USE_CUSTOM:
@@ -38,6 +44,95 @@
  *    uint8_t stpmic_read_i2c(uint8_t addr, uint8_t* buf, uint32_t len, uint32_t timeout);
  *    uint8_t stpmic_write_i2c(uint8_t addr, uint8_t* buf, uint32_t len, uint32_t timeout);
  * 
+ *  and if STPMIC_CUSTOM_COMBINED is set, below function too.
+ * 
+ *    uint8_t stpmic_read_reg_i2c(uint8_t addr, uint8_t reg, uint8_t* buf, uint32_t len, uint32_t timeout);
+ * 
+ *  and if STPMIC_USE_ASYNC is set, below function too.
+ * 
+ *    uint8_t stpmic_xfer_async_i2c(uint8_t addr, uint8_t reg, uint8_t* buf, uint32_t len, uint8_t rw);
+ * 
+ *  and if STPMIC_CUSTOM_TICK is set, below function too.
+ * 
+ *    uint32_t stpmic_get_tick_ms(void);
+ * 
+ * 4. STPMIC_USE_LINUX:
+ *  uses Linux `/dev/i2c-N` device, opened by `stpmic_linux_open` function.
+ *  multi-register operations are packed into a single `I2C_RDWR` ioctl.
+ *  for SMBus-only adapters (e.g. `i2c-stub`), SMBus I2C block transfers are used instead.
+ * 
+ * --
+ * combined read (`read_reg_i2c`, `stpmic_read_reg_i2c`):
+ * writes `reg` then reads `len` bytes after a repeated-start condition,
+ * without releasing the bus between them. `addr` is the write address.
+ * if not provided, reads are done by a write transfer and a read transfer.
+ * 
+ * --
+ * asynchronous transfer (`xfer_async`, `stpmic_xfer_async_i2c`, STPMIC_USE_ASYNC):
+ * starts writing `reg` and then reading (`rw` = 1) or writing (`rw` = 0) `len` bytes,
+ * returns non-zero if the transfer is started. `buf` is valid until the completion.
+ * on completion, `stpmic_async_complete` (`stpmic_ctx_async_complete` for a context) must be called,
+ * e.g. from ISR, or from a task with STPMIC_USE_LOCK.
+ * for STPMIC_USE_HAL, call it from `HAL_I2C_MemRxCpltCallback`, `HAL_I2C_MemTxCpltCallback`
+ * with `STPMIC_RET_OK` and from `HAL_I2C_ErrorCallback` with `STPMIC_RET_TIMEOUT`.
+ * 
+ * --
+ * deadline (`stpmic_deadline_begin`, `stpmic_xxx_within`):
+ * bounds the total time of a sequence of synchronous APIs by a budget in milliseconds.
+ * once the budget is exhausted, no more transfers are issued and APIs return `STPMIC_RET_DEADLINE`,
+ * and timeouts of transfers are shortened to the remaining budget.
+ * completed transfers are reported as progress, and their results are kept in the cache.
+ * this needs a millisecond tick: `HAL_GetTick` for STPMIC_USE_HAL, `get_tick` of `stpmic_i2c_t`
+ * for STPMIC_USE_CHAN, `stpmic_get_tick_ms` for STPMIC_USE_CUSTOM and `CLOCK_MONOTONIC` for STPMIC_USE_LINUX.
+ * 
+ * --
+ * transaction (`stpmic_txn_begin`, `stpmic_txn_commit`):
+ * stages writes to cached registers, then commits them in address order, adjacent ones in a single burst.
+ * `stpmic_buck_setup` and `stpmic_ldo_setup` stage into the active transaction, so rails can be set up together.
+ * if a transfer fails, registers written by the commit are restored to the values before it,
+ * and caches of registers in unknown state are cleared, to be read again.
+ * with STPMIC_USE_LOCK, the lock is held from `stpmic_txn_begin` until commit or abort.
+ * 
+ * --
+ * warm start (`stpmic_set_retain`, STPMIC_USE_RETAIN):
+ * keeps an image of the cache in a caller-provided `stpmic_retain_t`, e.g. in backup SRAM
+ * or a `.noinit` section, updated on every change of the cache.
+ * after an MCU-only reset, `stpmic_init` validates the image (magic, generation tag, address and CRC)
+ * and probes the device with a single burst read of `BUCKx_MAIN_CR` ~ `LDOx_MAIN_CR` instead of a full reload.
+ * if any of them doesn't match, e.g. the PMIC was restarted too, the cache is reloaded as usual.
+ * registers written by the firmware and the reference of restart checks are kept in the image too.
+ * the generation tag is given by the caller, change it when the configuration of the firmware changes.
+ * 
+ * --
+ * restart check (`stpmic_restart_check`):
+ * the STPMIC1 reloads registers from the NVM when it restarts, e.g. by the watchdog, thermal shutdown
+ * or a turn-off by PONKEY, while the MCU may keep running on another supply.
+ * `TURN_ON_SR` ~ `RESTART_SR` are read by a single burst and compared with the last ones,
+ * the first check takes the reference only, so call it once after init.
+ * reason bits only of `RESTART_SR`: `OP_MODE` and `LDO4_SRC` follow PWRCTRL and VBUS.
+ * if they differ, caches are invalidated except `VERSION_SR` and pending batch writes,
+ * and registers written by the firmware, including interrupt masks, are written again.
+ * call it periodically, and after interrupts that may precede a restart (`THW`, `PKEY`, `VINLOW`).
+ * 
+ * --
+ * reconciler (`stpmic_reconcile`, STPMIC_USE_RECONCILE):
+ * keeps the last written value of each writable cached register as the desired state,
+ * and compares a few of them with the device by a burst read on each call, from a periodic task.
+ * mismatched registers are reported to the drift callback and written again.
+ * bursts are paced by a token bucket, so the estimated bus time stays under the duty cycle cap.
+ * NVM shadow registers and registers that were never written are not reconciled, nor self-clearing command bits (`SWOFF`).
+ * 
+ * --
+ * thread safety (STPMIC_USE_LOCK):
+ * `stpmic_ctx_set_lock` sets lock hooks of a context, and the driver holds the lock
+ * during bus transactions and read-modify-write sequences of APIs.
+ * the lock must be recursive (e.g. `xSemaphoreTakeRecursive`), APIs call each other with the lock held.
+ * reads that hit the cache don't take the lock: they retry on the sequence counter of the cache,
+ * so a task can read cached values while another task is waiting for I2C transfers.
+ * contexts on a shared I2C bus can share a lock to serialize the bus too.
+ * completion of asynchronous operations takes the lock around the cache update,
+ * so with the lock, call `stpmic_ctx_async_complete` from a context that can take it (e.g. a deferred task), not from ISR.
+ * 
  * --
  * common notes for STPMIC_USE_CHAN and STPMIC_USE_CUSTOM.
  * --
@@ -47,10 +142,76 @@
  * it'll be handled as `failure` with error code: `STPMIC_RET_TIMEOUT`.
  */
 
+/* options can be also given by preprocessor definitions of the project. */
+#if !defined(STPMIC_USE_HAL) && !defined(STPMIC_USE_CHAN) && \
+    !defined(STPMIC_USE_CUSTOM) && !defined(STPMIC_USE_LINUX)
 #define STPMIC_USE_HAL      1   // --> use HAL to read/write registers.
+#endif
+
+#ifndef STPMIC_USE_HAL
+#define STPMIC_USE_HAL      0   // --> use HAL to read/write registers.
+#endif
+#ifndef STPMIC_USE_CHAN
 #define STPMIC_USE_CHAN     0   // --> use custom I2C channel pointer.
+#endif
+#ifndef STPMIC_USE_CUSTOM
 #define STPMIC_USE_CUSTOM   0   // --> use custom I2C channel functions.
+#endif
+#ifndef STPMIC_USE_LINUX
+#define STPMIC_USE_LINUX    0   // --> use Linux `/dev/i2c-N` device.
+#endif
+#ifndef STPMIC_INIT_DELAY
 #define STPMIC_INIT_DELAY   100 // --> initial delay settings.
+#endif
+#ifndef STPMIC_CUSTOM_COMBINED
+#define STPMIC_CUSTOM_COMBINED  0   // --> `stpmic_read_reg_i2c` is implemented.
+#endif
+#ifndef STPMIC_USE_ASYNC
+#define STPMIC_USE_ASYNC    0   // --> enable non-blocking APIs.
+#endif
+#ifndef STPMIC_ASYNC_DMA
+#define STPMIC_ASYNC_DMA    1   // --> STPMIC_USE_HAL: 1 for DMA, 0 for interrupt transfers.
+#endif
+#ifndef STPMIC_CUSTOM_TICK
+#define STPMIC_CUSTOM_TICK  0   // --> `stpmic_get_tick_ms` is implemented.
+#endif
+#ifndef STPMIC_TXN_MAX
+#define STPMIC_TXN_MAX      8   // --> maximum registers staged in a transaction, up to 16.
+#endif
+#ifndef STPMIC_READ_AHEAD
+#define STPMIC_READ_AHEAD   4   // --> registers read ahead of a cache miss in the same burst, 0 to disable.
+#endif
+#ifndef STPMIC_LAZY_INIT
+#define STPMIC_LAZY_INIT    0   // --> init reads `VERSION_SR` only, registers are cached on first access.
+#endif
+#ifndef STPMIC_USE_RETAIN
+#define STPMIC_USE_RETAIN   0   // --> keep the cache in retained RAM for warm start.
+#endif
+#ifndef STPMIC_USE_RECONCILE
+#define STPMIC_USE_RECONCILE    0   // --> compare written registers with the device and repair drifts.
+#endif
+#ifndef STPMIC_IRQ_RING
+#define STPMIC_IRQ_RING     0   // --> entries of the interrupt notification ring, power of 2 up to 128, e.g. 8 to enable.
+#endif
+#ifndef STPMIC_EVLOG_SIZE
+#define STPMIC_EVLOG_SIZE   0   // --> entries of the interrupt event log, power of 2 up to 128, 0 to disable.
+#endif
+#ifndef STPMIC_USE_OCP_POLICY
+#define STPMIC_USE_OCP_POLICY   0   // --> respond to overcurrents of rails in `stpmic_interrupt_dispatch`.
+#endif
+#ifndef STPMIC_USE_LOCK
+#define STPMIC_USE_LOCK     0   // --> enable lock hooks for multi-threaded use.
+#endif
+#ifndef STPMIC_SEQ_RETRY
+#define STPMIC_SEQ_RETRY    4   // --> lock-free cache read retries before taking the lock.
+#endif
+#ifndef STPMIC_BARRIER
+#if defined(__GNUC__) || defined(__clang__)
+#define STPMIC_BARRIER()    __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#else
+#define STPMIC_BARRIER()    // --> define a memory barrier for the compiler (e.g. `__DMB()`).
+#endif
+#endif
 
 #if STPMIC_USE_HAL
 #include "stpmic_hal.h"
@@ -66,6 +227,21 @@ uint8_t stpmic_read_i2c(uint8_t addr, uint8_t* buf, uint32_t len, uint32_t timeo
 
 /* write bytes using I2C: this should be implemented in somewhere. */
 uint8_t stpmic_write_i2c(uint8_t addr, uint8_t* buf, uint32_t len, uint32_t timeout);
+
+#if STPMIC_CUSTOM_COMBINED
+/* read registers using a combined write/repeated-start/read transfer. */
+uint8_t stpmic_read_reg_i2c(uint8_t addr, uint8_t reg, uint8_t* buf, uint32_t len, uint32_t timeout);
+#endif
+
+#if STPMIC_USE_ASYNC
+/* start a register transfer without blocking, rw: 1 for read. */
+uint8_t stpmic_xfer_async_i2c(uint8_t addr, uint8_t reg, uint8_t* buf, uint32_t len, uint8_t rw);
+#endif
+
+#if STPMIC_CUSTOM_TICK
+/* get a monotonic tick in milliseconds, for deadlines. */
+uint32_t stpmic_get_tick_ms(void);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -85,12 +261,44 @@ typedef struct stpmic_i2c_t {
     uint8_t (*write_i2c)(
         struct stpmic_i2c_t*, uint8_t addr,
         uint8_t* buf, uint32_t len, uint32_t timeout);
+
+    /* read registers using a combined write/repeated-start/read transfer, optional. */
+    uint8_t (*read_reg_i2c)(
+        struct stpmic_i2c_t*, uint8_t addr, uint8_t reg,
+        uint8_t* buf, uint32_t len, uint32_t timeout);
+
+    /* start a register transfer without blocking, rw: 1 for read, optional. */
+    uint8_t (*xfer_async)(
+        struct stpmic_i2c_t*, uint8_t addr, uint8_t reg,
+        uint8_t* buf, uint32_t len, uint8_t rw);
+
+    /* get a monotonic tick in milliseconds, for deadlines, optional. */
+    uint32_t (*get_tick)(struct stpmic_i2c_t*);
+} stpmic_i2c_t;
+#ifdef __cplusplus
+}
+#endif
+#elif STPMIC_USE_LINUX
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* I2C channel: `/dev/i2c-N` character device. */
+typedef struct stpmic_i2c_t {
+    int         fd;
+    uint32_t    funcs;  // --> `I2C_FUNCS` of the adapter.
+    int16_t     slave;  // --> address set by `I2C_SLAVE`, for SMBus transfers.
 } stpmic_i2c_t;
+
 #ifdef __cplusplus
 }
 #endif
 #else
-#error "please set 1 to one of STPMIC_USE_HAL, STPMIC_USE_CHAN and STPMIC_USE_CUSTOM."
+#error "please set 1 to one of STPMIC_USE_HAL, STPMIC_USE_CHAN, STPMIC_USE_CUSTOM and STPMIC_USE_LINUX."
+#endif
+
+#if STPMIC_USE_ASYNC && STPMIC_USE_LINUX
+#error "STPMIC_USE_ASYNC is not supported with STPMIC_USE_LINUX."
 #endif
 
 #ifdef __cplusplus
@@ -116,6 +324,7 @@ typedef enum {
     STPMIC_RET_DISABLED,
     STPMIC_RET_BUSY,
     STPMIC_RET_UNKNOWN,
+    STPMIC_RET_DEADLINE,
 } stpmic_ret_t;
 
 /* pull up or pull down. */
@@ -197,10 +406,10 @@ typedef enum {
     STPMIC_REG_INT_MASK_CLEAR_R2 = 0xa1,
     STPMIC_REG_INT_MASK_CLEAR_R3 = 0xa2,
     STPMIC_REG_INT_MASK_CLEAR_R4 = 0xa3,
-    STPMIC_REG_INT_SRC_R1 = 0x80,
-    STPMIC_REG_INT_SRC_R2 = 0x81,
-    STPMIC_REG_INT_SRC_R3 = 0x82,
-    STPMIC_REG_INT_SRC_R4 = 0x83,
+    STPMIC_REG_INT_SRC_R1 = 0xb0,
+    STPMIC_REG_INT_SRC_R2 = 0xb1,
+    STPMIC_REG_INT_SRC_R3 = 0xb2,
+    STPMIC_REG_INT_SRC_R4 = 0xb3,
 
     /* NVM registers. */
     STPMIC_REG_NVM_SR = 0xb8,   // 0th: busy.
@@ -229,6 +438,361 @@ typedef enum {
     STPMIC_REG_LDO6_MAIN_CR  = STPMIC_REG_LDOx_MAIN_CR + 5,
 } stpmic_regid_t;
 
+/* register attributes, these drive the cache policy. */
+typedef enum {
+    STPMIC_REGATTR_NONE     = 0,                    // --> reserved address.
+    STPMIC_REGATTR_RO       = STPMIC_BIT_MASK(0),   // --> read-only.
+    STPMIC_REGATTR_VOLATILE = STPMIC_BIT_MASK(1),   // --> changed by the device, always read from the device.
+    STPMIC_REGATTR_W1C      = STPMIC_BIT_MASK(2),   // --> writing 1 triggers an action (clear, mask set/clear).
+    STPMIC_REGATTR_CACHE    = STPMIC_BIT_MASK(3),   // --> served from the cache.
+    STPMIC_REGATTR_NVM      = STPMIC_BIT_MASK(4),   // --> NVM shadow register.
+    STPMIC_REGATTR_CONST    = STPMIC_BIT_MASK(5),   // --> never changes, read once.
+} stpmic_regattr_t;
+
+/* get attributes of a register, `STPMIC_REGATTR_xxx` bits. */
+uint8_t stpmic_reg_attr(stpmic_regid_t reg);
+
+/**
+ * cached registers, ordered by address: X(name, register, attributes besides `CACHE`).
+ * only these take a slot of the cache, `STPMIC_SLOT_xxx` is the index of the slot.
+ * bursts from the cache span registers in adjacent slots only, an entry out of order splits them.
+ */
+#define STPMIC_CACHED_REGS(X) \
+    X(VERSION_SR,       STPMIC_REG_VERSION_SR,          STPMIC_REGATTR_RO | STPMIC_REGATTR_CONST) \
+    X(MAIN_CR,          STPMIC_REG_MAIN_CR,             STPMIC_REGATTR_NONE) \
+    X(PADS_PULL_CR,     STPMIC_REG_PADS_PULL_CR,        STPMIC_REGATTR_NONE) \
+    X(BUCKS_PD_CR,      STPMIC_REG_BUCKS_PD_CR,         STPMIC_REGATTR_NONE) \
+    X(LDO1234_PD_CR,    STPMIC_REG_LDO1234_PD_CR,       STPMIC_REGATTR_NONE) \
+    X(LDO56_VREF_PD_CR, STPMIC_REG_LDO56_VREF_PD_CR,    STPMIC_REGATTR_NONE) \
+    X(SW_VIN_CR,        STPMIC_REG_SW_VIN_CR,           STPMIC_REGATTR_NONE) \
+    X(PKEY_TURNOFF_CR,  STPMIC_REG_PKEY_TURNOFF_CR,     STPMIC_REGATTR_NONE) \
+    X(BUCKS_MRST_CR,    STPMIC_REG_BUCKS_MRST_CR,       STPMIC_REGATTR_NONE) \
+    X(LDOS_MRST_CR,     STPMIC_REG_LDOS_MRST_CR,        STPMIC_REGATTR_NONE) \
+    X(WDG_TMR_CR,       STPMIC_REG_WDG_TMR_CR,          STPMIC_REGATTR_NONE) \
+    X(BUCK1_MAIN_CR,    STPMIC_REG_BUCKx_MAIN_CR + 0,   STPMIC_REGATTR_NONE) \
+    X(BUCK2_MAIN_CR,    STPMIC_REG_BUCKx_MAIN_CR + 1,   STPMIC_REGATTR_NONE) \
+    X(BUCK3_MAIN_CR,    STPMIC_REG_BUCKx_MAIN_CR + 2,   STPMIC_REGATTR_NONE) \
+    X(BUCK4_MAIN_CR,    STPMIC_REG_BUCKx_MAIN_CR + 3,   STPMIC_REGATTR_NONE) \
+    X(REFDDR_MAIN_CR,   STPMIC_REG_REFDDR_MAIN_CR,      STPMIC_REGATTR_NONE) \
+    X(LDO1_MAIN_CR,     STPMIC_REG_LDOx_MAIN_CR + 0,    STPMIC_REGATTR_NONE) \
+    X(LDO2_MAIN_CR,     STPMIC_REG_LDOx_MAIN_CR + 1,    STPMIC_REGATTR_NONE) \
+    X(LDO3_MAIN_CR,     STPMIC_REG_LDOx_MAIN_CR + 2,    STPMIC_REGATTR_NONE) \
+    X(LDO4_MAIN_CR,     STPMIC_REG_LDOx_MAIN_CR + 3,    STPMIC_REGATTR_NONE) \
+    X(LDO5_MAIN_CR,     STPMIC_REG_LDOx_MAIN_CR + 4,    STPMIC_REGATTR_NONE) \
+    X(LDO6_MAIN_CR,     STPMIC_REG_LDOx_MAIN_CR + 5,    STPMIC_REGATTR_NONE) \
+    X(BUCK1_ALT_CR,     STPMIC_REG_BUCKx_ALT_CR + 0,    STPMIC_REGATTR_NONE) \
+    X(BUCK2_ALT_CR,     STPMIC_REG_BUCKx_ALT_CR + 1,    STPMIC_REGATTR_NONE) \
+    X(BUCK3_ALT_CR,     STPMIC_REG_BUCKx_ALT_CR + 2,    STPMIC_REGATTR_NONE) \
+    X(BUCK4_ALT_CR,     STPMIC_REG_BUCKx_ALT_CR + 3,    STPMIC_REGATTR_NONE) \
+    X(REFDDR_ALT_CR,    STPMIC_REG_REFDDR_ALT_CR,       STPMIC_REGATTR_NONE) \
+    X(LDO1_ALT_CR,      STPMIC_REG_LDOx_ALT_CR + 0,     STPMIC_REGATTR_NONE) \
+    X(LDO2_ALT_CR,      STPMIC_REG_LDOx_ALT_CR + 1,     STPMIC_REGATTR_NONE) \
+    X(LDO3_ALT_CR,      STPMIC_REG_LDOx_ALT_CR + 2,     STPMIC_REGATTR_NONE) \
+    X(LDO4_ALT_CR,      STPMIC_REG_LDOx_ALT_CR + 3,     STPMIC_REGATTR_NONE) \
+    X(LDO5_ALT_CR,      STPMIC_REG_LDOx_ALT_CR + 4,     STPMIC_REGATTR_NONE) \
+    X(LDO6_ALT_CR,      STPMIC_REG_LDOx_ALT_CR + 5,     STPMIC_REGATTR_NONE) \
+    X(INT_MASK_R1,      STPMIC_REG_INT_MASK_R1,         STPMIC_REGATTR_RO) \
+    X(INT_MASK_R2,      STPMIC_REG_INT_MASK_R2,         STPMIC_REGATTR_RO) \
+    X(INT_MASK_R3,      STPMIC_REG_INT_MASK_R3,         STPMIC_REGATTR_RO) \
+    X(INT_MASK_R4,      STPMIC_REG_INT_MASK_R4,         STPMIC_REGATTR_RO) \
+    X(NVM_MAIN_CTRL,    STPMIC_REG_NVM_MAIN_CTRL_SHR,   STPMIC_REGATTR_NVM) \
+    X(NVM_BUCKS_RANK,   STPMIC_REG_NVM_BUCKS_RANK_SHR,  STPMIC_REGATTR_NVM) \
+    X(NVM_LDOS_RANK1,   STPMIC_REG_NVM_LDOS_RANK_SHR1,  STPMIC_REGATTR_NVM) \
+    X(NVM_LDOS_RANK2,   STPMIC_REG_NVM_LDOS_RANK_SHR2,  STPMIC_REGATTR_NVM) \
+    X(NVM_BUCKS_VOUT,   STPMIC_REG_NVM_BUCKS_VOUT_SHR,  STPMIC_REGATTR_NVM) \
+    X(NVM_LDOS_VOUT1,   STPMIC_REG_NVM_LDOS_VOUT_SHR1,  STPMIC_REGATTR_NVM) \
+    X(NVM_LDOS_VOUT2,   STPMIC_REG_NVM_LDOS_VOUT_SHR2,  STPMIC_REGATTR_NVM) \
+    X(I2C_ADDR,         STPMIC_REG_I2C_ADDR_SHR,        STPMIC_REGATTR_NVM)
+
+/* slots of the register cache. */
+#define STPMIC_SLOT_ENUM(name, reg, attr)    STPMIC_SLOT_##name,
+typedef enum {
+    STPMIC_CACHED_REGS(STPMIC_SLOT_ENUM)
+    STPMIC_CACHE_SLOTS
+} stpmic_slot_t;
+#undef STPMIC_SLOT_ENUM
+
+/* maximum length of a single auto-increment transfer. */
+#define STPMIC_BURST_MAX    16
+
+#if STPMIC_USE_ASYNC
+/* maximum steps of an asynchronous operation. */
+#define STPMIC_ASYNC_STEPS  4
+
+/**
+ * completion callback of asynchronous operations.
+ * this is called from the context that calls `stpmic_async_complete`.
+ */
+typedef void (*stpmic_async_cb_t)(stpmic_ret_t ret, void* arg);
+
+/* a transfer of asynchronous operation. */
+typedef struct {
+    uint8_t             reg;
+    uint8_t             len;
+    uint8_t             rw;     // --> 0: write, 1: read.
+    stpmic_reg_t*       out;    // --> copy read values to, nullable.
+    stpmic_reg_t        buf[STPMIC_BURST_MAX];
+} stpmic_async_step_t;
+#endif
+
+/* progress of an operation under a deadline. */
+typedef struct {
+    uint32_t            elapsed;    // --> milliseconds.
+    uint16_t            xfers;      // --> completed transfers.
+    uint16_t            regs;       // --> registers transferred by them.
+} stpmic_progress_t;
+
+#if STPMIC_USE_LOCK
+/* lock hooks, the lock must be recursive. */
+typedef struct {
+    void                (*lock)(void* arg);
+    void                (*unlock)(void* arg);
+    void*               arg;
+} stpmic_lock_t;
+#endif
+
+#if STPMIC_USE_RETAIN
+/* image of the cache in retained RAM, contents are managed by the driver. */
+typedef struct {
+    uint32_t            magic;
+    uint32_t            gen;        // --> generation tag given by `stpmic_ctx_set_retain`.
+    uint16_t            crc;        // --> CRC-16 of members below.
+    uint8_t             addr;
+    uint8_t             valid[(STPMIC_CACHE_SLOTS + 7) / 8];
+    uint8_t             owned[(STPMIC_CACHE_SLOTS + 7) / 8];
+    stpmic_reg_t        status[5];  // --> reference of restart checks.
+    uint8_t             status_known;
+    stpmic_reg_t        cache[STPMIC_CACHE_SLOTS];
+} stpmic_retain_t;
+#endif
+
+#if STPMIC_USE_RECONCILE
+/* drift callback, called with the lock held and `found` is replaced by `want` after this returns. */
+typedef void (*stpmic_drift_cb_t)(stpmic_regid_t reg, stpmic_reg_t want, stpmic_reg_t found, void* arg);
+
+/* reconciler settings. */
+typedef struct {
+    uint32_t            bus_hz;     // --> I2C bus clock, to estimate bus time of transfers.
+    uint16_t            duty;       // --> maximum bus duty cycle of the reconciler, in permille.
+    uint8_t             burst;      // --> registers compared by a burst, up to `STPMIC_BURST_MAX`.
+    stpmic_drift_cb_t   cb;         // --> nullable.
+    void*               arg;
+} stpmic_reconcile_t;
+#endif
+
+/* count of `STPMIC_INTFLAG_xxx` flags, size of a handler table. */
+#define STPMIC_INTFLAG_COUNT    32
+
+#if STPMIC_EVLOG_SIZE
+/* an entry of the event log, occurrences of a flag within a window are coalesced into one. */
+typedef struct {
+    uint8_t             bit;        // --> bit number of `STPMIC_INTFLAG_xxx`.
+    uint16_t            count;      // --> occurrences, saturated at 0xffff.
+    uint32_t            first;      // --> tick of the first occurrence, in milliseconds.
+    uint32_t            last;       // --> tick of the last occurrence.
+} stpmic_event_t;
+
+/* event log settings. */
+typedef struct {
+    uint32_t            window;     // --> coalescing and rate limiting window of each flag, in milliseconds.
+    uint8_t             limit[STPMIC_INTFLAG_COUNT];    // --> handler calls per window, by bit number, 0 for no limit.
+} stpmic_evlog_t;
+#endif
+
+#if STPMIC_USE_OCP_POLICY
+/* rails with an overcurrent flag, index of `stpmic_ocp_policy_t::rails`. */
+enum {
+    STPMIC_OCP_BUCK1 = 0,
+    STPMIC_OCP_BUCK2,
+    STPMIC_OCP_BUCK3,
+    STPMIC_OCP_BUCK4,
+    STPMIC_OCP_LDO1,
+    STPMIC_OCP_LDO2,
+    STPMIC_OCP_LDO3,
+    STPMIC_OCP_LDO4,
+    STPMIC_OCP_LDO5,
+    STPMIC_OCP_LDO6,
+    STPMIC_OCP_SWOUT,   // --> no control register, `STPMIC_OCP_IGNORE` or `STPMIC_OCP_SWOFF` only.
+    STPMIC_OCP_RAILS
+};
+
+/* responses to an overcurrent. */
+enum {
+    STPMIC_OCP_IGNORE = 0,  // --> left to handlers.
+    STPMIC_OCP_DISABLE,     // --> disable the rail by `xxx_MAIN_CR`.
+    STPMIC_OCP_RETRY,       // --> disable, then enable again by `stpmic_ocp_poll` after the backoff.
+    STPMIC_OCP_SWOFF,       // --> request switch-off of the PMIC.
+};
+
+/* response of a rail. */
+typedef struct {
+    uint8_t             action;     // --> `STPMIC_OCP_xxx`.
+    uint8_t             escalate;   // --> RETRY: `STPMIC_OCP_DISABLE` or `STPMIC_OCP_SWOFF` once retries are spent.
+    uint8_t             retries;    // --> RETRY: 1 ~ 15.
+    uint16_t            backoff;    // --> RETRY: delay of the first retry in milliseconds, doubled by each retry.
+} stpmic_ocp_rule_t;
+
+/* overcurrent policy. */
+typedef struct {
+    stpmic_ocp_rule_t   rails[STPMIC_OCP_RAILS];
+} stpmic_ocp_policy_t;
+#endif
+
+/**
+ * STPMIC driver context, a STPMIC device on an I2C bus.
+ * members are managed by the driver, and a zero-initialized context can be passed to `stpmic_ctx_init`.
+ * APIs without `ctx` parameter use `STPMIC_CTX_DEFAULT`.
+ */
+typedef struct stpmic_ctx_t {
+#if !STPMIC_USE_CUSTOM
+    stpmic_i2c_t*       dev;
+#endif
+    int16_t             addr;
+    uint8_t             state;
+
+    /* read/write timeout. */
+    uint32_t            timeout_r;
+    uint32_t            timeout_w;
+    
+    /* cache, indexed by `STPMIC_SLOT_xxx`. */
+    stpmic_reg_t        cache[STPMIC_CACHE_SLOTS];
+
+    /* valid bitmap: slots that hold the value of the device. */
+    uint8_t             valid[(STPMIC_CACHE_SLOTS + 7) / 8];
+
+    /* dirty bitmap: slots reserved by `stpmic_batch_write`. */
+    uint8_t             dirty[(STPMIC_CACHE_SLOTS + 7) / 8];
+
+    /* owned bitmap: slots configured by writes, re-applied after a restart of the device. */
+    uint8_t             owned[(STPMIC_CACHE_SLOTS + 7) / 8];
+
+    /* `TURN_ON_SR` ~ `RESTART_SR` at the last restart check, and restarts detected. */
+    stpmic_reg_t        status[5];
+    uint8_t             status_known;
+    uint32_t            restarts;
+
+    /* writes skipped by `stpmic_update_bits`, the value was unchanged. */
+    uint32_t            skips;
+
+    /* reads of cached registers: hits, misses and registers filled by read-ahead of misses. */
+    uint32_t            hits;
+    uint32_t            misses;
+    uint32_t            ahead;
+
+    /* deadline of the current operation. */
+    struct {
+        uint8_t             active;
+        uint8_t             expired;
+        uint32_t            start;
+        uint32_t            budget;
+        uint32_t            left;       // --> remaining budget at the last transfer.
+        stpmic_progress_t   progress;
+    } deadline;
+
+    /* transaction in progress, staged writes. */
+    struct {
+        uint8_t             active;
+        uint8_t             count;
+        uint8_t             reg[STPMIC_TXN_MAX];
+        stpmic_reg_t        val[STPMIC_TXN_MAX];
+    } txn;
+
+#if STPMIC_USE_RECONCILE
+    /* desired state, indexed by `STPMIC_SLOT_xxx`. */
+    struct {
+        stpmic_reconcile_t  opts;
+        stpmic_reg_t        want[STPMIC_CACHE_SLOTS];
+        uint8_t             next;       // --> register to compare next.
+        int32_t             credit;     // --> bus time that can be spent, in microseconds.
+        uint32_t            last;       // --> tick of the last call.
+        uint32_t            drifts;     // --> registers found drifted.
+        uint32_t            passes;     // --> completed passes over owned registers.
+    } rec;
+#endif
+
+#if STPMIC_IRQ_RING
+    /* interrupt notifications: `head` is written by `stpmic_irq_notify`, `tail` by `stpmic_irq_service`. */
+    struct {
+        volatile uint8_t    head;
+        volatile uint8_t    tail;
+        uint32_t            stamp[STPMIC_IRQ_RING];
+        volatile uint32_t   overflows;  // --> notifications dropped on a full ring.
+        uint32_t            since;      // --> stamp of the oldest notification of the last service.
+    } irq;
+#endif
+
+#if STPMIC_EVLOG_SIZE
+    /* interrupt event log, entries in `[tail, head)`. */
+    struct {
+        stpmic_evlog_t      opts;
+        uint8_t             enabled;
+        uint8_t             head;
+        uint8_t             tail;
+        uint8_t             open[STPMIC_INTFLAG_COUNT];     // --> entry of each flag in the current window.
+        uint16_t            calls[STPMIC_INTFLAG_COUNT];    // --> handler calls of each flag in the current window.
+        uint32_t            start[STPMIC_INTFLAG_COUNT];    // --> start of the current window of each flag.
+        uint32_t            dropped;    // --> entries overwritten before read.
+        uint32_t            suppressed; // --> handler calls skipped by rate limits.
+        stpmic_event_t      ring[STPMIC_EVLOG_SIZE];
+    } evlog;
+#endif
+
+#if STPMIC_USE_OCP_POLICY
+    /* overcurrent policy and retries of rails. */
+    struct {
+        stpmic_ocp_policy_t opts;
+        uint8_t             enabled;
+        uint16_t            waiting;                    // --> bitmap of rails to enable again.
+        uint8_t             tries[STPMIC_OCP_RAILS];    // --> retries spent.
+        uint32_t            due[STPMIC_OCP_RAILS];      // --> tick to enable again, or of the last retry.
+        uint32_t            trips;                      // --> responses executed.
+    } ocp;
+#endif
+
+#if STPMIC_USE_RETAIN
+    /* retained image of the cache. */
+    stpmic_retain_t*    retain;
+    uint32_t            gen;
+    uint8_t             warm;       // --> 1 if initialized from the retained image.
+#endif
+
+#if STPMIC_USE_LOCK
+    stpmic_lock_t       lock;
+
+    /* sequence counter of the cache, odd while the cache is being updated. */
+    volatile uint32_t   seq;
+#endif
+
+#if STPMIC_USE_ASYNC
+    /* asynchronous operation in flight. */
+    struct {
+        volatile uint8_t    busy;
+        uint8_t             step;
+        uint8_t             count;
+        stpmic_async_step_t steps[STPMIC_ASYNC_STEPS];
+
+        /* called when queued steps are completed, can queue more steps. */
+        stpmic_ret_t        (*next)(struct stpmic_ctx_t*);
+        stpmic_ret_t        result;
+        stpmic_async_cb_t   cb;
+        void*               arg;
+
+        /* parameters of high-level operations. */
+        uint8_t             reg;
+        uint8_t             nth;
+        uint8_t             mask;
+        uint8_t             val;
+        uint8_t             pd;
+        stpmic_reg_t        temp[4];
+        uint32_t*           out32;
+    } async;
+#endif
+} stpmic_ctx_t;
+
+/* the default context. */
+extern stpmic_ctx_t stpmic_default_ctx;
+#define STPMIC_CTX_DEFAULT  (&stpmic_default_ctx)
+
 /* timeout. */
 typedef struct {
     uint32_t write;
@@ -236,24 +800,52 @@ typedef struct {
 } stpmic_timeout_t;
 
 /* set timeout of STPMIC driver. */
-void stpmic_set_timeout(stpmic_timeout_t* in);
+void stpmic_ctx_set_timeout(stpmic_ctx_t* ctx, stpmic_timeout_t* in);
 
 /* get timeout of STPMIC driver. */
-void stpmic_get_timeout(stpmic_timeout_t* out);
+void stpmic_ctx_get_timeout(stpmic_ctx_t* ctx, stpmic_timeout_t* out);
+
+#if STPMIC_USE_LOCK
+/**
+ * set lock hooks of STPMIC driver, this should be called before sharing the context.
+ * @param in lock hooks, NULL to remove.
+ */
+void stpmic_ctx_set_lock(stpmic_ctx_t* ctx, const stpmic_lock_t* in);
+
+/* take the lock to make a sequence of APIs atomic, recursive. */
+void stpmic_ctx_lock(stpmic_ctx_t* ctx);
+
+/* release the lock that is taken by `stpmic_ctx_lock`. */
+void stpmic_ctx_unlock(stpmic_ctx_t* ctx);
+#endif
+
+#if STPMIC_USE_RETAIN
+/**
+ * set the retained image of the cache, this should be called before `stpmic_ctx_init`.
+ * the image is used for warm start by the next `stpmic_ctx_init`, and kept in sync until `stpmic_ctx_deinit`.
+ * @param area image in retained RAM, NULL to remove.
+ * @param gen generation tag, an image with a different one is discarded.
+ * @return
+ * `STPMIC_RET_ALREADY` if STPMIC driver is already initialized.
+ */
+stpmic_ret_t stpmic_ctx_set_retain(stpmic_ctx_t* ctx, stpmic_retain_t* area, uint32_t gen);
+#endif
 
 #if STPMIC_USE_CUSTOM
 /**
- * initialize the STPMIC driver.
+ * initialize the STPMIC driver, and read cached registers.
+ * with STPMIC_LAZY_INIT, only `VERSION_SR` is read and others are cached on first access.
  * @param addr I2C device address, `-1` to use default value.
  * @return
  * `STPMIC_RET_ALREADY` if STPMIC driver is already initialized.
  * `STPMIC_RET_TIMEOUT` if timeout reached.
  * `STPMIC_RET_NOTSUP` if chip's major version is not supported by driver.
  */
-stpmic_ret_t stpmic_init(int16_t addr);
+stpmic_ret_t stpmic_ctx_init(stpmic_ctx_t* ctx, int16_t addr);
 #else
 /**
- * initialize the STPMIC driver.
+ * initialize the STPMIC driver, and read cached registers.
+ * with STPMIC_LAZY_INIT, only `VERSION_SR` is read and others are cached on first access.
  * @param dev I2C peripheral.
  * @param addr I2C device address, `-1` to use default value.
  * @return
@@ -262,7 +854,32 @@ stpmic_ret_t stpmic_init(int16_t addr);
  * `STPMIC_RET_TIMEOUT` if timeout reached.
  * `STPMIC_RET_NOTSUP` if chip's major version is not supported by driver.
  */
-stpmic_ret_t stpmic_init(stpmic_i2c_t* dev, int16_t addr);
+stpmic_ret_t stpmic_ctx_init(stpmic_ctx_t* ctx, stpmic_i2c_t* dev, int16_t addr);
+#endif
+
+/**
+ * de-initialize the STPMIC driver, the driver can be initialized again.
+ * this discards register caches and pending batch writes, and the retained image with STPMIC_USE_RETAIN.
+ * @return
+ * `STPMIC_RET_NODEV` if STPMIC driver is not initialized.
+ * `STPMIC_RET_BUSY` if an asynchronous operation is in flight.
+ */
+stpmic_ret_t stpmic_ctx_deinit(stpmic_ctx_t* ctx);
+
+#if STPMIC_USE_LINUX
+/**
+ * open `/dev/i2c-N` device for STPMIC driver.
+ * @param dev I2C channel to initialize.
+ * @param path path of the device, e.g. `/dev/i2c-1`.
+ * @return
+ * `STPMIC_RET_INVALID` if `dev` or `path` is `NULL`.
+ * `STPMIC_RET_NODEV` if the device couldn't be opened.
+ * `STPMIC_RET_NOTSUP` if the adapter supports neither I2C nor SMBus I2C block transfers.
+ */
+stpmic_ret_t stpmic_linux_open(stpmic_i2c_t* dev, const char* path);
+
+/* close `/dev/i2c-N` device. */
+void stpmic_linux_close(stpmic_i2c_t* dev);
 #endif
 
 /**
@@ -274,7 +891,20 @@ stpmic_ret_t stpmic_init(stpmic_i2c_t* dev, int16_t addr);
  * `STPMIC_RET_TIMEOUT` if timeout reached.
  * `STPMIC_RET_INVALID` if register ID is bigger than `STPMIC_REG_MAX`.
  */
-stpmic_ret_t stpmic_read_direct(stpmic_regid_t reg, stpmic_reg_t* out);
+stpmic_ret_t stpmic_ctx_read_direct(stpmic_ctx_t* ctx, stpmic_regid_t reg, stpmic_reg_t* out);
+
+/**
+ * read contiguous registers of STPMIC without cache.
+ * this reads `len` registers in a single auto-increment transfer.
+ * @param reg The first register ID to read.
+ * @param out A buffer to store `len` values.
+ * @param len count of registers to read.
+ * @return
+ * `STPMIC_RET_NODEV` if STPMIC driver is not ready.
+ * `STPMIC_RET_TIMEOUT` if timeout reached.
+ * `STPMIC_RET_INVALID` if `out` is `NULL`, `len` is zero or the range exceeds `STPMIC_REG_MAX`.
+ */
+stpmic_ret_t stpmic_ctx_read_burst(stpmic_ctx_t* ctx, stpmic_regid_t reg, stpmic_reg_t* out, uint8_t len);
 
 /**
  * write a register of STPMIC without cache.
@@ -285,10 +915,24 @@ stpmic_ret_t stpmic_read_direct(stpmic_regid_t reg, stpmic_reg_t* out);
  * `STPMIC_RET_TIMEOUT` if timeout reached.
  * `STPMIC_RET_INVALID` if register ID is bigger than `STPMIC_REG_MAX`.
  */
-stpmic_ret_t stpmic_write_direct(stpmic_regid_t reg, stpmic_reg_t val);
+stpmic_ret_t stpmic_ctx_write_direct(stpmic_ctx_t* ctx, stpmic_regid_t reg, stpmic_reg_t val);
+
+/**
+ * write contiguous registers of STPMIC without cache.
+ * this writes `len` registers using auto-increment transfers.
+ * @param reg The first register ID to write.
+ * @param in `len` values to write.
+ * @param len count of registers to write.
+ * @return
+ * `STPMIC_RET_NODEV` if STPMIC driver is not ready.
+ * `STPMIC_RET_TIMEOUT` if timeout reached.
+ * `STPMIC_RET_INVALID` if `in` is `NULL`, `len` is zero or the range exceeds `STPMIC_REG_MAX`.
+ */
+stpmic_ret_t stpmic_ctx_write_burst(stpmic_ctx_t* ctx, stpmic_regid_t reg, const stpmic_reg_t* in, uint8_t len);
 
 /**
  * read a register of STPMIC with cache.
+ * volatile registers (status, interrupt and NVM status) are always read from the device.
  * @param reg A register ID to read.
  * @param out A pointer to store value.
  * @return
@@ -296,18 +940,35 @@ stpmic_ret_t stpmic_write_direct(stpmic_regid_t reg, stpmic_reg_t val);
  * `STPMIC_RET_TIMEOUT` if timeout reached.
  * `STPMIC_RET_INVALID` if register ID is bigger than `STPMIC_REG_MAX`.
  */
-stpmic_ret_t stpmic_read(stpmic_regid_t reg, stpmic_reg_t* out);
+stpmic_ret_t stpmic_ctx_read(stpmic_ctx_t* ctx, stpmic_regid_t reg, stpmic_reg_t* out);
 
 /**
  * write a register of STPMIC with cache.
+ * writes to cached registers are skipped if the value is same with the cache.
  * @param reg A register ID to write.
  * @param val A value to write.
  * @return
  * `STPMIC_RET_NODEV` if STPMIC driver is not ready.
  * `STPMIC_RET_TIMEOUT` if timeout reached.
  * `STPMIC_RET_INVALID` if register ID is bigger than `STPMIC_REG_MAX`.
+ * `STPMIC_RET_NOTSUP` if the register is read-only.
  */
-stpmic_ret_t stpmic_write(stpmic_regid_t reg, stpmic_reg_t val);
+stpmic_ret_t stpmic_ctx_write(stpmic_ctx_t* ctx, stpmic_regid_t reg, stpmic_reg_t val);
+
+/**
+ * update bits of a register: `(org & ~mask) | (val & mask)`.
+ * the original value is read from the cache, and if the value is unchanged for a cached register,
+ * nothing is written and `skips` of the context is increased.
+ * @param reg A register ID to update.
+ * @param mask bits to update.
+ * @param val new values of the bits.
+ * @return
+ * `STPMIC_RET_NODEV` if STPMIC driver is not ready.
+ * `STPMIC_RET_TIMEOUT` if timeout reached.
+ * `STPMIC_RET_INVALID` if register ID is bigger than `STPMIC_REG_MAX`.
+ * `STPMIC_RET_NOTSUP` if the register is read-only.
+ */
+stpmic_ret_t stpmic_ctx_update_bits(stpmic_ctx_t* ctx, stpmic_regid_t reg, stpmic_reg_t mask, stpmic_reg_t val);
 
 /**
  * clear a register cache.
@@ -316,7 +977,7 @@ stpmic_ret_t stpmic_write(stpmic_regid_t reg, stpmic_reg_t val);
  * `STPMIC_RET_NODEV` if STPMIC driver is not ready.
  * `STPMIC_RET_INVALID` if register ID is bigger than `STPMIC_REG_MAX`.
  */
-stpmic_ret_t stpmic_clear_cache(stpmic_regid_t reg);
+stpmic_ret_t stpmic_ctx_clear_cache(stpmic_ctx_t* ctx, stpmic_regid_t reg);
 
 /**
  * reserve to write a register of STPMIC.
@@ -326,16 +987,18 @@ stpmic_ret_t stpmic_clear_cache(stpmic_regid_t reg);
  * @return
  * `STPMIC_RET_NODEV` if STPMIC driver is not ready.
  * `STPMIC_RET_INVALID` if register ID is bigger than `STPMIC_REG_MAX`.
+ * `STPMIC_RET_NOTSUP` if the register is read-only or not cached.
  */
-stpmic_ret_t stpmic_batch_write(stpmic_regid_t reg, stpmic_reg_t val);
+stpmic_ret_t stpmic_ctx_batch_write(stpmic_ctx_t* ctx, stpmic_regid_t reg, stpmic_reg_t val);
 
 /**
  * flush all pending batch writes.
+ * only reserved registers are written, adjacent ones in a single burst.
  * @return
  * `STPMIC_RET_NODEV` if STPMIC driver is not ready.
  * `STPMIC_RET_TIMEOUT` if timeout reached.
  */
-stpmic_ret_t stpmic_batch_flush();
+stpmic_ret_t stpmic_ctx_batch_flush(stpmic_ctx_t* ctx);
 
 /**
  * reload all cached registers.
@@ -343,7 +1006,138 @@ stpmic_ret_t stpmic_batch_flush();
  * `STPMIC_RET_NODEV` if STPMIC driver is not ready.
  * `STPMIC_RET_TIMEOUT` if timeout reached.
  */
-stpmic_ret_t stpmic_reload_cache();
+stpmic_ret_t stpmic_ctx_reload_cache(stpmic_ctx_t* ctx);
+
+/**
+ * begin a deadline: synchronous APIs until `stpmic_deadline_end` share the budget.
+ * with STPMIC_USE_LOCK, the lock is held until `stpmic_deadline_end`.
+ * @param budget total time budget in milliseconds.
+ * @return
+ * `STPMIC_RET_NODEV` if STPMIC driver is not ready.
+ * `STPMIC_RET_NOTSUP` if no tick source is available.
+ * `STPMIC_RET_ALREADY` if a deadline is already active.
+ */
+stpmic_ret_t stpmic_ctx_deadline_begin(stpmic_ctx_t* ctx, uint32_t budget);
+
+/**
+ * end the deadline.
+ * @param out progress of the operation, nullable.
+ * @return
+ * `STPMIC_RET_INVALID` if no deadline is active.
+ * `STPMIC_RET_DEADLINE` if the budget was exhausted.
+ */
+stpmic_ret_t stpmic_ctx_deadline_end(stpmic_ctx_t* ctx, stpmic_progress_t* out);
+
+/**
+ * flush all pending batch writes within the budget.
+ * registers that are not written remain reserved, so this can be called again to resume.
+ * @param budget total time budget in milliseconds.
+ * @param out progress of the operation, nullable.
+ * @return
+ * `STPMIC_RET_NODEV` if STPMIC driver is not ready.
+ * `STPMIC_RET_NOTSUP` if no tick source is available.
+ * `STPMIC_RET_TIMEOUT` if timeout reached.
+ * `STPMIC_RET_DEADLINE` if the budget was exhausted.
+ */
+stpmic_ret_t stpmic_ctx_batch_flush_within(stpmic_ctx_t* ctx, uint32_t budget, stpmic_progress_t* out);
+
+/**
+ * reload all cached registers within the budget.
+ * registers that are reloaded before the budget exhausted are kept in the cache.
+ * @param budget total time budget in milliseconds.
+ * @param out progress of the operation, nullable.
+ * @return
+ * `STPMIC_RET_NODEV` if STPMIC driver is not ready.
+ * `STPMIC_RET_NOTSUP` if no tick source is available.
+ * `STPMIC_RET_TIMEOUT` if timeout reached.
+ * `STPMIC_RET_DEADLINE` if the budget was exhausted.
+ */
+stpmic_ret_t stpmic_ctx_reload_cache_within(stpmic_ctx_t* ctx, uint32_t budget, stpmic_progress_t* out);
+
+/**
+ * begin a transaction: `stpmic_txn_write`, `stpmic_txn_update_bits` and setup APIs stage writes
+ * until `stpmic_txn_commit` or `stpmic_txn_abort`.
+ * with STPMIC_USE_LOCK, the lock is held until the transaction ends,
+ * so begin, commit and abort must be called from the same thread.
+ * commit and abort from other threads wait for the lock, then return `STPMIC_RET_INVALID`.
+ * @return
+ * `STPMIC_RET_NODEV` if STPMIC driver is not ready.
+ * `STPMIC_RET_ALREADY` if a transaction is already active.
+ */
+stpmic_ret_t stpmic_ctx_txn_begin(stpmic_ctx_t* ctx);
+
+/**
+ * stage a write to a register in the transaction.
+ * @param reg A register ID to write, must be cached.
+ * @param val A value to write.
+ * @return
+ * `STPMIC_RET_NODEV` if STPMIC driver is not ready.
+ * `STPMIC_RET_TIMEOUT` if timeout reached while reading the register.
+ * `STPMIC_RET_INVALID` if register ID is bigger than `STPMIC_REG_MAX` or no transaction is active.
+ * `STPMIC_RET_NOTSUP` if the register is read-only or not cached.
+ * `STPMIC_RET_RANGE` if `STPMIC_TXN_MAX` registers are staged already.
+ */
+stpmic_ret_t stpmic_ctx_txn_write(stpmic_ctx_t* ctx, stpmic_regid_t reg, stpmic_reg_t val);
+
+/**
+ * stage an update of bits of a register in the transaction, on the staged value if any.
+ * @param reg A register ID to update, must be cached.
+ * @param mask bits to update.
+ * @param val new values of the bits.
+ * @return same with `stpmic_txn_write`.
+ */
+stpmic_ret_t stpmic_ctx_txn_update_bits(stpmic_ctx_t* ctx, stpmic_regid_t reg, stpmic_reg_t mask, stpmic_reg_t val);
+
+/**
+ * commit the transaction: staged values that differ from the cache are written in address order.
+ * @return
+ * `STPMIC_RET_INVALID` if no transaction is active.
+ * `STPMIC_RET_BUSY` if an asynchronous operation is in flight, nothing is written.
+ * `STPMIC_RET_TIMEOUT` if timeout reached, written registers are restored.
+ * `STPMIC_RET_DEADLINE` if the budget was exhausted, written registers are restored.
+ */
+stpmic_ret_t stpmic_ctx_txn_commit(stpmic_ctx_t* ctx);
+
+/**
+ * abort the transaction, staged writes are discarded.
+ * @return
+ * `STPMIC_RET_INVALID` if no transaction is active.
+ */
+stpmic_ret_t stpmic_ctx_txn_abort(stpmic_ctx_t* ctx);
+
+/**
+ * check whether the device was restarted or not, then re-apply written registers if restarted.
+ * the first call after init takes the reference and reports no restart.
+ * @param out set to 1 if a restart was detected, nullable.
+ * @return
+ * `STPMIC_RET_NODEV` if STPMIC driver is not ready.
+ * `STPMIC_RET_BUSY` if an asynchronous operation is in flight.
+ * `STPMIC_RET_TIMEOUT` if timeout reached.
+ */
+stpmic_ret_t stpmic_ctx_restart_check(stpmic_ctx_t* ctx, uint8_t* out);
+
+#if STPMIC_USE_RECONCILE
+/**
+ * set up the reconciler, the desired state is kept regardless of this.
+ * @param in settings, NULL to stop.
+ * @return
+ * `STPMIC_RET_NODEV` if STPMIC driver is not ready.
+ * `STPMIC_RET_INVALID` if `bus_hz`, `duty` or `burst` is zero or out of range.
+ * `STPMIC_RET_NOTSUP` if no tick source is available.
+ */
+stpmic_ret_t stpmic_ctx_reconcile_setup(stpmic_ctx_t* ctx, const stpmic_reconcile_t* in);
+
+/**
+ * compare the next burst of written registers with the device, and write drifted ones again.
+ * call this periodically, it returns without transfers while the duty cycle cap doesn't allow a burst.
+ * @return
+ * `STPMIC_RET_NODEV` if STPMIC driver is not ready.
+ * `STPMIC_RET_DISABLED` if the reconciler is not set up.
+ * `STPMIC_RET_BUSY` if an asynchronous operation is in flight.
+ * `STPMIC_RET_TIMEOUT` if timeout reached.
+ */
+stpmic_ret_t stpmic_ctx_reconcile(stpmic_ctx_t* ctx);
+#endif
 
 /* STPMIC's version. */
 typedef struct {
@@ -358,7 +1152,7 @@ typedef struct {
  * `STPMIC_RET_NODEV` if STPMIC driver is not ready.
  * `STPMIC_RET_TIMEOUT` if timeout reached.
  */
-stpmic_ret_t stpmic_version(stpmic_version_t* out);
+stpmic_ret_t stpmic_ctx_version(stpmic_ctx_t* ctx, stpmic_version_t* out);
 
 /* bits of TURN_ON_SR. */
 enum {
@@ -379,8 +1173,8 @@ enum {
 };
 
 /* get the TURN_ON_SR register value. */
-static inline stpmic_ret_t stpmic_tonsr(stpmic_reg_t* out) {
-    return stpmic_read(STPMIC_REG_TURN_ON_SR, out);
+static inline stpmic_ret_t stpmic_ctx_tonsr(stpmic_ctx_t* ctx, stpmic_reg_t* out) {
+    return stpmic_ctx_read(ctx, STPMIC_REG_TURN_ON_SR, out);
 }
 
 /* bits of TURN_OFF_SR. */
@@ -405,8 +1199,8 @@ enum {
 };
 
 /* get the TURN_OFF_SR register value. */
-static inline stpmic_ret_t stpmic_tofsr(stpmic_reg_t* out) {
-    return stpmic_read(STPMIC_REG_TURN_OFF_SR, out);
+static inline stpmic_ret_t stpmic_ctx_tofsr(stpmic_ctx_t* ctx, stpmic_reg_t* out) {
+    return stpmic_ctx_read(ctx, STPMIC_REG_TURN_OFF_SR, out);
 }
 
 /* bits of N'th LDO in OCP_LDOS_SR, nth: 1 ~ 6. */
@@ -424,8 +1218,8 @@ enum {
 };
 
 /* get the OCP_LDOS_SR register value. */
-static inline stpmic_ret_t stpmic_ocpldosr(stpmic_reg_t* out) {
-    return stpmic_read_direct(STPMIC_REG_OCP_LDOS_SR, out);
+static inline stpmic_ret_t stpmic_ctx_ocpldosr(stpmic_ctx_t* ctx, stpmic_reg_t* out) {
+    return stpmic_ctx_read_direct(ctx, STPMIC_REG_OCP_LDOS_SR, out);
 }
 
 /* bits of N'th LDO in OCP_BUCKS_BSW_SR, nth: 1 ~ 7. */
@@ -443,8 +1237,8 @@ enum {
 };
 
 /* get the OCP_BUCKS_BSW_SR register value. */
-static inline stpmic_ret_t stpmic_ocpbucksbsw(stpmic_reg_t* out) {
-    return stpmic_read_direct(STPMIC_REG_OCP_LDOS_SR, out);
+static inline stpmic_ret_t stpmic_ctx_ocpbucksbsw(stpmic_ctx_t* ctx, stpmic_reg_t* out) {
+    return stpmic_ctx_read_direct(ctx, STPMIC_REG_OCP_LDOS_SR, out);
 }
 
 /* bits of RESTART_SR. */
@@ -489,8 +1283,8 @@ enum {
 };
 
 /* get the RESTART_SR register value. */
-static inline stpmic_ret_t stpmic_restartsr(stpmic_reg_t* out) {
-    return stpmic_read(STPMIC_REG_RESTART_SR, out);
+static inline stpmic_ret_t stpmic_ctx_restartsr(stpmic_ctx_t* ctx, stpmic_reg_t* out) {
+    return stpmic_ctx_read(ctx, STPMIC_REG_RESTART_SR, out);
 }
 
 /* STPMIC's operating mode.*/
@@ -501,7 +1295,7 @@ enum {
 };
 
 /* get the STPMIC's operating mode. */
-uint8_t stpmic_opmode_is_main();
+uint8_t stpmic_ctx_opmode_is_main(stpmic_ctx_t* ctx);
 
 /* LDO4's input source. */
 typedef enum {
@@ -513,7 +1307,7 @@ typedef enum {
 } stpmic_ldo4src_t;
 
 /* get the LDO4'th input source. */
-uint8_t stpmic_ldo4_src(stpmic_reg_t in);
+uint8_t stpmic_ctx_ldo4_src(stpmic_ctx_t* ctx, stpmic_reg_t in);
 
 /* bits of MAIN_CR. */
 enum {
@@ -553,12 +1347,12 @@ enum {
 };
 
 /* get the MAIN_CR register value. */
-static inline stpmic_ret_t stpmic_maincr(stpmic_reg_t* out) {
-    return stpmic_read(STPMIC_REG_MAIN_CR, out);
+static inline stpmic_ret_t stpmic_ctx_maincr(stpmic_ctx_t* ctx, stpmic_reg_t* out) {
+    return stpmic_ctx_read(ctx, STPMIC_REG_MAIN_CR, out);
 }
 
-/* request `software switch` off. */
-stpmic_ret_t stpmic_request_swoff();
+/* request `software switch` off, the command is not cached and never applied again on restart. */
+stpmic_ret_t stpmic_ctx_request_swoff(stpmic_ctx_t* ctx);
 
 /* bits of PADS_PULL_CR. */
 enum {
@@ -595,8 +1389,8 @@ enum {
 };
 
 /* get the PADS_PULL_CR register value. */
-static inline stpmic_ret_t stpmic_padspullcr(stpmic_reg_t* out) {
-    return stpmic_read(STPMIC_REG_PADS_PULL_CR, out);
+static inline stpmic_ret_t stpmic_ctx_padspullcr(stpmic_ctx_t* ctx, stpmic_reg_t* out) {
+    return stpmic_ctx_read(ctx, STPMIC_REG_PADS_PULL_CR, out);
 }
 
 /* structure for initializing PWRCTRL pin. */
@@ -614,16 +1408,16 @@ typedef struct {
 } stpmic_pwrctrl_t;
 
 /* initialize the PWRCTRL pin's functionality. */
-stpmic_ret_t stpmic_pwrctrl_init(stpmic_pwrctrl_t* pwrctrl);
+stpmic_ret_t stpmic_ctx_pwrctrl_init(stpmic_ctx_t* ctx, stpmic_pwrctrl_t* pwrctrl);
 
 /* enable the PWRCTRL pin's functionality. */
-stpmic_ret_t stpmic_pwrctrl_enable();
+stpmic_ret_t stpmic_ctx_pwrctrl_enable(stpmic_ctx_t* ctx);
 
 /* enable the PWRCTRL pin's functionality. */
-stpmic_ret_t stpmic_pwrctrl_disable();
+stpmic_ret_t stpmic_ctx_pwrctrl_disable(stpmic_ctx_t* ctx);
 
 /* de-initialize PWRCTRL functionality. */
-stpmic_ret_t stpmic_pwrctrl_deinit();
+stpmic_ret_t stpmic_ctx_pwrctrl_deinit(stpmic_ctx_t* ctx);
 
 /* structure for initializing WAKE-UP pin. */
 typedef struct {
@@ -632,10 +1426,10 @@ typedef struct {
 } stpmic_wakeup_t;
 
 /* initialize the WAKE-UP pin's functionality. */
-stpmic_ret_t stpmic_wakeup_init(stpmic_wakeup_t* wakeup);
+stpmic_ret_t stpmic_ctx_wakeup_init(stpmic_ctx_t* ctx, stpmic_wakeup_t* wakeup);
 
 /* de-initialize the WAKE-UP pin's functionality. */
-stpmic_ret_t stpmic_wakeup_deinit();
+stpmic_ret_t stpmic_ctx_wakeup_deinit(stpmic_ctx_t* ctx);
 
 /**
  * BUCK's discharge pull-down mode. 
@@ -660,8 +1454,8 @@ enum {
 };
 
 /* get the BUCKS_PD_CR register value. */
-static inline stpmic_ret_t stpmic_buckspd(stpmic_reg_t* out) {
-    return stpmic_read(STPMIC_REG_BUCKS_PD_CR, out);
+static inline stpmic_ret_t stpmic_ctx_buckspd(stpmic_ctx_t* ctx, stpmic_reg_t* out) {
+    return stpmic_ctx_read(ctx, STPMIC_REG_BUCKS_PD_CR, out);
 }
 
 /* encode BUCKS_PD_CR bits and set. */
@@ -698,8 +1492,8 @@ enum {
 };
 
 /* get the LDO14_PD_CR register value. */
-static inline stpmic_ret_t stpmic_ldo1234pd(stpmic_reg_t* out) {
-    return stpmic_read(STPMIC_REG_LDO1234_PD_CR, out);
+static inline stpmic_ret_t stpmic_ctx_ldo1234pd(stpmic_ctx_t* ctx, stpmic_reg_t* out) {
+    return stpmic_ctx_read(ctx, STPMIC_REG_LDO1234_PD_CR, out);
 }
 
 /* encode LDO12344_PD_CR bits and set. */
@@ -733,8 +1527,8 @@ enum {
 };
 
 /* get the LDO56_VREF_PD_CR register value. */
-static inline stpmic_ret_t stpmic_ldo56pd(stpmic_reg_t* out) {
-    return stpmic_read(STPMIC_REG_LDO56_VREF_PD_CR, out);
+static inline stpmic_ret_t stpmic_ctx_ldo56pd(stpmic_ctx_t* ctx, stpmic_reg_t* out) {
+    return stpmic_ctx_read(ctx, STPMIC_REG_LDO56_VREF_PD_CR, out);
 }
 
 /* encode LDO56_PD_CR bits and set, nth: 5 ~ 7, 7: REFDDR. */
@@ -785,8 +1579,8 @@ enum {
 };
 
 /* get the SW_VIN_CR register value. */
-static inline stpmic_ret_t stpmic_swvincr(stpmic_reg_t* out) {
-    return stpmic_read(STPMIC_REG_SW_VIN_CR, out);
+static inline stpmic_ret_t stpmic_ctx_swvincr(stpmic_ctx_t* ctx, stpmic_reg_t* out) {
+    return stpmic_ctx_read(ctx, STPMIC_REG_SW_VIN_CR, out);
 }
 
 /* bits of PKEY_TURNOFF_CR. */
@@ -815,8 +1609,8 @@ enum {
 };
 
 /* get the PKEY_TURNOFF_CR register value. */
-static inline stpmic_ret_t stpmic_pkeytofcr(stpmic_reg_t* out) {
-    return stpmic_read(STPMIC_REG_PKEY_TURNOFF_CR, out);
+static inline stpmic_ret_t stpmic_ctx_pkeytofcr(stpmic_ctx_t* ctx, stpmic_reg_t* out) {
+    return stpmic_ctx_read(ctx, STPMIC_REG_PKEY_TURNOFF_CR, out);
 }
 
 /**
@@ -841,10 +1635,10 @@ enum {
 };
 
 /* get the MRST masks from BUCKS_MRST_CR and LDOS_MRST_CR. */
-stpmic_ret_t stpmic_mrst(uint16_t* out);
+stpmic_ret_t stpmic_ctx_mrst(stpmic_ctx_t* ctx, uint16_t* out);
 
 /* set the MRST masks from BUCKS_MRST_CR and LDOS_MRST_CR. */
-stpmic_ret_t stpmic_set_mrst(uint16_t val);
+stpmic_ret_t stpmic_ctx_set_mrst(stpmic_ctx_t* ctx, uint16_t val);
 
 /* watchdog initialization parameters. */
 typedef struct {
@@ -853,16 +1647,16 @@ typedef struct {
 } stpmic_watchdog_t;
 
 /* deinitialize the watchdog timer. */
-static inline stpmic_ret_t stpmic_watchdog_deinit() {
+static inline stpmic_ret_t stpmic_ctx_watchdog_deinit(stpmic_ctx_t* ctx) {
     /* (MSB) RESV | RST(1) | ENA(1) (LSB). */
-    return stpmic_write_direct(STPMIC_REG_WDG_CR, (1u << 1) | (0u << 0));
+    return stpmic_ctx_write_direct(ctx, STPMIC_REG_WDG_CR, (1u << 1) | (0u << 0));
 }
 
 /* initialize the watchdog timer, sec: 1 ~ 255, 0: disable. */
-stpmic_ret_t stpmic_watchdog_init(uint8_t sec);
+stpmic_ret_t stpmic_ctx_watchdog_init(stpmic_ctx_t* ctx, uint8_t sec);
 
 /* reset the watchdog counter to default counter. */
-stpmic_ret_t stpmic_watchdog_reset();
+stpmic_ret_t stpmic_ctx_watchdog_reset(stpmic_ctx_t* ctx);
 
 /**
  * Power regulation mode.
@@ -1025,24 +1819,24 @@ typedef struct {
 } stpmic_buck_t;
 
 /* get the BUCKx_MAIN_CR register value. */
-static inline stpmic_ret_t stpmic_buck_main_cr(uint8_t nth, stpmic_reg_t* out) {
+static inline stpmic_ret_t stpmic_ctx_buck_main_cr(stpmic_ctx_t* ctx, uint8_t nth, stpmic_reg_t* out) {
     if (nth <= 0 || nth > 4) {
         return STPMIC_RET_RANGE;
     }
 
-    return stpmic_read(
-        (stpmic_regid_t)(STPMIC_REG_BUCKx_MAIN_CR + (nth - 1)),
+    return stpmic_ctx_read(
+        ctx, (stpmic_regid_t)(STPMIC_REG_BUCKx_MAIN_CR + (nth - 1)),
         out);
 }
 
 /* get the BUCKx_ALT_CR register value. */
-static inline stpmic_ret_t stpmic_buck_alt_cr(uint8_t nth, stpmic_reg_t* out) {
+static inline stpmic_ret_t stpmic_ctx_buck_alt_cr(stpmic_ctx_t* ctx, uint8_t nth, stpmic_reg_t* out) {
     if (nth <= 0 || nth > 4) {
         return STPMIC_RET_RANGE;
     }
 
-    return stpmic_read(
-        (stpmic_regid_t)(STPMIC_REG_BUCKx_ALT_CR + (nth - 1)),
+    return stpmic_ctx_read(
+        ctx, (stpmic_regid_t)(STPMIC_REG_BUCKx_ALT_CR + (nth - 1)),
         out);
 }
 
@@ -1056,7 +1850,7 @@ static inline stpmic_ret_t stpmic_buck_alt_cr(uint8_t nth, stpmic_reg_t* out) {
  * `STPMIC_RET_TIMEOUT` if timeout reached.
  * `STPMIC_RET_RANGE` if `nth` value is out of range.
  */
-stpmic_ret_t __stpmic_buck_setup(uint8_t nth, uint8_t alt, stpmic_buck_t* opts);
+stpmic_ret_t __stpmic_ctx_buck_setup(stpmic_ctx_t* ctx, uint8_t nth, uint8_t alt, stpmic_buck_t* opts);
 
 /**
  * setup the specified buck converter.
@@ -1067,8 +1861,8 @@ stpmic_ret_t __stpmic_buck_setup(uint8_t nth, uint8_t alt, stpmic_buck_t* opts);
  * `STPMIC_RET_TIMEOUT` if timeout reached.
  * `STPMIC_RET_RANGE` if `nth` value is out of range.
  */
-static inline stpmic_ret_t stpmic_buck_setup(uint8_t nth, stpmic_buck_t* opts) {
-    return __stpmic_buck_setup(nth, 0, opts);
+static inline stpmic_ret_t stpmic_ctx_buck_setup(stpmic_ctx_t* ctx, uint8_t nth, stpmic_buck_t* opts) {
+    return __stpmic_ctx_buck_setup(ctx, nth, 0, opts);
 }
 
 /**
@@ -1080,8 +1874,8 @@ static inline stpmic_ret_t stpmic_buck_setup(uint8_t nth, stpmic_buck_t* opts) {
  * `STPMIC_RET_TIMEOUT` if timeout reached.
  * `STPMIC_RET_RANGE` if `nth` value is out of range.
  */
-static inline stpmic_ret_t stpmic_buck_alt_setup(uint8_t nth, stpmic_buck_t* opts) {
-    return __stpmic_buck_setup(nth, 1, opts);
+static inline stpmic_ret_t stpmic_ctx_buck_alt_setup(stpmic_ctx_t* ctx, uint8_t nth, stpmic_buck_t* opts) {
+    return __stpmic_ctx_buck_setup(ctx, nth, 1, opts);
 }
 
 /**
@@ -1093,7 +1887,7 @@ static inline stpmic_ret_t stpmic_buck_alt_setup(uint8_t nth, stpmic_buck_t* opt
  * `STPMIC_RET_TIMEOUT` if timeout reached.
  * `STPMIC_RET_RANGE` if `nth` value is out of range.
  */
-stpmic_ret_t __stpmic_buck_enable(uint8_t nth, uint8_t alt);
+stpmic_ret_t __stpmic_ctx_buck_enable(stpmic_ctx_t* ctx, uint8_t nth, uint8_t alt);
 
 /**
  * enable the specified buck converter.
@@ -1103,8 +1897,8 @@ stpmic_ret_t __stpmic_buck_enable(uint8_t nth, uint8_t alt);
  * `STPMIC_RET_TIMEOUT` if timeout reached.
  * `STPMIC_RET_RANGE` if `nth` value is out of range.
  */
-static inline stpmic_ret_t stpmic_buck_enable(uint8_t nth) {
-    return __stpmic_buck_enable(nth, 0);
+static inline stpmic_ret_t stpmic_ctx_buck_enable(stpmic_ctx_t* ctx, uint8_t nth) {
+    return __stpmic_ctx_buck_enable(ctx, nth, 0);
 }
 
 /**
@@ -1116,8 +1910,9 @@ static inline stpmic_ret_t stpmic_buck_enable(uint8_t nth) {
  * `STPMIC_RET_TIMEOUT` if timeout reached.
  * `STPMIC_RET_RANGE` if `nth` value is out of range.
  */
-static inline stpmic_ret_t stpmic_buck_alt_enable(uint8_t nth, uint8_t alt) {
-    return __stpmic_buck_enable(nth, 1);
+static inline stpmic_ret_t stpmic_ctx_buck_alt_enable(stpmic_ctx_t* ctx, uint8_t nth, uint8_t alt) {
+    (void) alt;
+    return __stpmic_ctx_buck_enable(ctx, nth, 1);
 }
 
 /**
@@ -1129,7 +1924,7 @@ static inline stpmic_ret_t stpmic_buck_alt_enable(uint8_t nth, uint8_t alt) {
  * `STPMIC_RET_TIMEOUT` if timeout reached.
  * `STPMIC_RET_RANGE` if `nth` value is out of range.
  */
-stpmic_ret_t __stpmic_buck_disable(uint8_t nth, uint8_t alt);
+stpmic_ret_t __stpmic_ctx_buck_disable(stpmic_ctx_t* ctx, uint8_t nth, uint8_t alt);
 
 /**
  * disable the specified buck converter.
@@ -1139,8 +1934,8 @@ stpmic_ret_t __stpmic_buck_disable(uint8_t nth, uint8_t alt);
  * `STPMIC_RET_TIMEOUT` if timeout reached.
  * `STPMIC_RET_RANGE` if `nth` value is out of range.
  */
-static inline stpmic_ret_t stpmic_buck_disable(uint8_t nth) {
-    return __stpmic_buck_disable(nth, 0);
+static inline stpmic_ret_t stpmic_ctx_buck_disable(stpmic_ctx_t* ctx, uint8_t nth) {
+    return __stpmic_ctx_buck_disable(ctx, nth, 0);
 }
 
 /**
@@ -1152,8 +1947,9 @@ static inline stpmic_ret_t stpmic_buck_disable(uint8_t nth) {
  * `STPMIC_RET_TIMEOUT` if timeout reached.
  * `STPMIC_RET_RANGE` if `nth` value is out of range.
  */
-static inline stpmic_ret_t stpmic_buck_alt_disable(uint8_t nth, uint8_t alt) {
-    return __stpmic_buck_disable(nth, 1);
+static inline stpmic_ret_t stpmic_ctx_buck_alt_disable(stpmic_ctx_t* ctx, uint8_t nth, uint8_t alt) {
+    (void) alt;
+    return __stpmic_ctx_buck_disable(ctx, nth, 1);
 }
 
 /* LDO parameters. */
@@ -1261,7 +2057,7 @@ typedef enum {
  * `STPMIC_RET_TIMEOUT` if timeout reached.
  * `STPMIC_RET_RANGE` if `nth` value is out of range.
  */
-stpmic_ret_t __stpmic_ldo_setup(uint8_t nth, uint8_t alt, stpmic_ldo_t* opts);
+stpmic_ret_t __stpmic_ctx_ldo_setup(stpmic_ctx_t* ctx, uint8_t nth, uint8_t alt, stpmic_ldo_t* opts);
 
 /**
  * setup the specified LDO.
@@ -1272,8 +2068,8 @@ stpmic_ret_t __stpmic_ldo_setup(uint8_t nth, uint8_t alt, stpmic_ldo_t* opts);
  * `STPMIC_RET_TIMEOUT` if timeout reached.
  * `STPMIC_RET_RANGE` if `nth` value is out of range.
  */
-static inline stpmic_ret_t stpmic_ldo_setup(uint8_t nth, stpmic_ldo_t* opts) {
-    return __stpmic_ldo_setup(nth, 0, opts);
+static inline stpmic_ret_t stpmic_ctx_ldo_setup(stpmic_ctx_t* ctx, uint8_t nth, stpmic_ldo_t* opts) {
+    return __stpmic_ctx_ldo_setup(ctx, nth, 0, opts);
 }
 
 /**
@@ -1285,8 +2081,8 @@ static inline stpmic_ret_t stpmic_ldo_setup(uint8_t nth, stpmic_ldo_t* opts) {
  * `STPMIC_RET_TIMEOUT` if timeout reached.
  * `STPMIC_RET_RANGE` if `nth` value is out of range.
  */
-static inline stpmic_ret_t stpmic_ldo_alt_setup(uint8_t nth, stpmic_ldo_t* opts) {
-    return __stpmic_ldo_setup(nth, 1, opts);
+static inline stpmic_ret_t stpmic_ctx_ldo_alt_setup(stpmic_ctx_t* ctx, uint8_t nth, stpmic_ldo_t* opts) {
+    return __stpmic_ctx_ldo_setup(ctx, nth, 1, opts);
 }
 
 /**
@@ -1298,7 +2094,7 @@ static inline stpmic_ret_t stpmic_ldo_alt_setup(uint8_t nth, stpmic_ldo_t* opts)
  * `STPMIC_RET_TIMEOUT` if timeout reached.
  * `STPMIC_RET_RANGE` if `nth` value is out of range.
  */
-stpmic_ret_t __stpmic_ldo_enable(uint8_t nth, uint8_t alt);
+stpmic_ret_t __stpmic_ctx_ldo_enable(stpmic_ctx_t* ctx, uint8_t nth, uint8_t alt);
 
 /**
  * enable the specified LDO.
@@ -1308,8 +2104,8 @@ stpmic_ret_t __stpmic_ldo_enable(uint8_t nth, uint8_t alt);
  * `STPMIC_RET_TIMEOUT` if timeout reached.
  * `STPMIC_RET_RANGE` if `nth` value is out of range.
  */
-static inline stpmic_ret_t stpmic_ldo_enable(uint8_t nth) {
-    return __stpmic_ldo_enable(nth, 0);
+static inline stpmic_ret_t stpmic_ctx_ldo_enable(stpmic_ctx_t* ctx, uint8_t nth) {
+    return __stpmic_ctx_ldo_enable(ctx, nth, 0);
 }
 
 /**
@@ -1320,8 +2116,8 @@ static inline stpmic_ret_t stpmic_ldo_enable(uint8_t nth) {
  * `STPMIC_RET_TIMEOUT` if timeout reached.
  * `STPMIC_RET_RANGE` if `nth` value is out of range.
  */
-static inline stpmic_ret_t stpmic_ldo_alt_enable(uint8_t nth) {
-    return __stpmic_ldo_enable(nth, 1);
+static inline stpmic_ret_t stpmic_ctx_ldo_alt_enable(stpmic_ctx_t* ctx, uint8_t nth) {
+    return __stpmic_ctx_ldo_enable(ctx, nth, 1);
 }
 
 /**
@@ -1333,7 +2129,7 @@ static inline stpmic_ret_t stpmic_ldo_alt_enable(uint8_t nth) {
  * `STPMIC_RET_TIMEOUT` if timeout reached.
  * `STPMIC_RET_RANGE` if `nth` value is out of range.
  */
-stpmic_ret_t __stpmic_ldo_disable(uint8_t nth, uint8_t alt);
+stpmic_ret_t __stpmic_ctx_ldo_disable(stpmic_ctx_t* ctx, uint8_t nth, uint8_t alt);
 
 /**
  * disable the specified LDO.
@@ -1343,8 +2139,8 @@ stpmic_ret_t __stpmic_ldo_disable(uint8_t nth, uint8_t alt);
  * `STPMIC_RET_TIMEOUT` if timeout reached.
  * `STPMIC_RET_RANGE` if `nth` value is out of range.
  */
-static inline stpmic_ret_t stpmic_ldo_disable(uint8_t nth) {
-    return __stpmic_ldo_disable(nth, 1);
+static inline stpmic_ret_t stpmic_ctx_ldo_disable(stpmic_ctx_t* ctx, uint8_t nth) {
+    return __stpmic_ctx_ldo_disable(ctx, nth, 1);
 }
 
 /**
@@ -1355,8 +2151,8 @@ static inline stpmic_ret_t stpmic_ldo_disable(uint8_t nth) {
  * `STPMIC_RET_TIMEOUT` if timeout reached.
  * `STPMIC_RET_RANGE` if `nth` value is out of range.
  */
-static inline stpmic_ret_t stpmic_ldo_alt_disable(uint8_t nth) {
-    return __stpmic_ldo_disable(nth, 1);
+static inline stpmic_ret_t stpmic_ctx_ldo_alt_disable(stpmic_ctx_t* ctx, uint8_t nth) {
+    return __stpmic_ctx_ldo_disable(ctx, nth, 1);
 }
 
 /**
@@ -1368,7 +2164,7 @@ static inline stpmic_ret_t stpmic_ldo_alt_disable(uint8_t nth) {
  * `STPMIC_RET_TIMEOUT` if timeout reached.
  * `STPMIC_RET_RANGE` if `nth` value is out of range.
  */
-stpmic_ret_t __stpmic_refddr_enable(uint8_t alt);
+stpmic_ret_t __stpmic_ctx_refddr_enable(stpmic_ctx_t* ctx, uint8_t alt);
 
 /**
  * enable the REFDDR.
@@ -1378,8 +2174,8 @@ stpmic_ret_t __stpmic_refddr_enable(uint8_t alt);
  * `STPMIC_RET_TIMEOUT` if timeout reached.
  * `STPMIC_RET_RANGE` if `nth` value is out of range.
  */
-static inline stpmic_ret_t stpmic_refddr_enable() {
-    return __stpmic_refddr_enable(0);
+static inline stpmic_ret_t stpmic_ctx_refddr_enable(stpmic_ctx_t* ctx) {
+    return __stpmic_ctx_refddr_enable(ctx, 0);
 }
 
 /**
@@ -1390,8 +2186,8 @@ static inline stpmic_ret_t stpmic_refddr_enable() {
  * `STPMIC_RET_TIMEOUT` if timeout reached.
  * `STPMIC_RET_RANGE` if `nth` value is out of range.
  */
-static inline stpmic_ret_t stpmic_refddr_alt_enable() {
-    return __stpmic_refddr_enable(1);
+static inline stpmic_ret_t stpmic_ctx_refddr_alt_enable(stpmic_ctx_t* ctx) {
+    return __stpmic_ctx_refddr_enable(ctx, 1);
 }
 
 /**
@@ -1403,7 +2199,7 @@ static inline stpmic_ret_t stpmic_refddr_alt_enable() {
  * `STPMIC_RET_TIMEOUT` if timeout reached.
  * `STPMIC_RET_RANGE` if `nth` value is out of range.
  */
-stpmic_ret_t __stpmic_refddr_disable(uint8_t alt);
+stpmic_ret_t __stpmic_ctx_refddr_disable(stpmic_ctx_t* ctx, uint8_t alt);
 
 /**
  * disable the REFDDR.
@@ -1413,8 +2209,8 @@ stpmic_ret_t __stpmic_refddr_disable(uint8_t alt);
  * `STPMIC_RET_TIMEOUT` if timeout reached.
  * `STPMIC_RET_RANGE` if `nth` value is out of range.
  */
-static inline stpmic_ret_t stpmic_refddr_disable() {
-    return __stpmic_refddr_enable(0);
+static inline stpmic_ret_t stpmic_ctx_refddr_disable(stpmic_ctx_t* ctx) {
+    return __stpmic_ctx_refddr_enable(ctx, 0);
 }
 
 /**
@@ -1425,8 +2221,8 @@ static inline stpmic_ret_t stpmic_refddr_disable() {
  * `STPMIC_RET_TIMEOUT` if timeout reached.
  * `STPMIC_RET_RANGE` if `nth` value is out of range.
  */
-static inline stpmic_ret_t stpmic_refddr_alt_disable() {
-    return __stpmic_refddr_enable(0);
+static inline stpmic_ret_t stpmic_ctx_refddr_alt_disable(stpmic_ctx_t* ctx) {
+    return __stpmic_ctx_refddr_enable(ctx, 0);
 }
 
 /* interrupt flags. */
@@ -1528,7 +2324,7 @@ enum {
  * `STPMIC_RET_NODEV` if STPMIC driver is not ready.
  * `STPMIC_RET_TIMEOUT` if timeout reached.
  */
-stpmic_ret_t stpmic_interrupt_pending(uint32_t* out);
+stpmic_ret_t stpmic_ctx_interrupt_pending(stpmic_ctx_t* ctx, uint32_t* out);
 
 /**
  * clear interrupts.
@@ -1536,7 +2332,7 @@ stpmic_ret_t stpmic_interrupt_pending(uint32_t* out);
  * `STPMIC_RET_NODEV` if STPMIC driver is not ready.
  * `STPMIC_RET_TIMEOUT` if timeout reached.
  */
-stpmic_ret_t stpmic_interrupt_clear(uint32_t bitmap);
+stpmic_ret_t stpmic_ctx_interrupt_clear(stpmic_ctx_t* ctx, uint32_t bitmap);
 
 /**
  * get interrupt masks, `INT_MASK_Rx`. 
@@ -1544,7 +2340,7 @@ stpmic_ret_t stpmic_interrupt_clear(uint32_t bitmap);
  * `STPMIC_RET_NODEV` if STPMIC driver is not ready.
  * `STPMIC_RET_TIMEOUT` if timeout reached.
  */
-stpmic_ret_t stpmic_interrupt_read_mask(uint32_t* out);
+stpmic_ret_t stpmic_ctx_interrupt_read_mask(stpmic_ctx_t* ctx, uint32_t* out);
 
 /**
  * set interrupt masks.
@@ -1552,7 +2348,7 @@ stpmic_ret_t stpmic_interrupt_read_mask(uint32_t* out);
  * `STPMIC_RET_NODEV` if STPMIC driver is not ready.
  * `STPMIC_RET_TIMEOUT` if timeout reached.
  */
-stpmic_ret_t stpmic_interrupt_mask_set(uint32_t bitmap) ;
+stpmic_ret_t stpmic_ctx_interrupt_mask_set(stpmic_ctx_t* ctx, uint32_t bitmap);
 
 /**
  * clear interrupt masks.
@@ -1560,7 +2356,7 @@ stpmic_ret_t stpmic_interrupt_mask_set(uint32_t bitmap) ;
  * `STPMIC_RET_NODEV` if STPMIC driver is not ready.
  * `STPMIC_RET_TIMEOUT` if timeout reached.
  */
-stpmic_ret_t stpmic_interrupt_mask_clear(uint32_t bitmap);
+stpmic_ret_t stpmic_ctx_interrupt_mask_clear(stpmic_ctx_t* ctx, uint32_t bitmap);
 
 /* interrupt source flags. */
 enum {
@@ -1640,15 +2436,114 @@ enum {
  * `STPMIC_RET_NODEV` if STPMIC driver is not ready.
  * `STPMIC_RET_TIMEOUT` if timeout reached.
  */
-stpmic_ret_t stpmic_interrupt_read_source(uint32_t* out);
+stpmic_ret_t stpmic_ctx_interrupt_read_source(stpmic_ctx_t* ctx, uint32_t* out);
+
+/**
+ * deprecated, use `stpmic_ctx_interrupt_clear` instead.
+ * `INT_SRC_Rx` registers are read-only, so `bitmap` is written to `INT_CLEAR_Rx` like `stpmic_ctx_interrupt_clear`.
+ * @return
+ * `STPMIC_RET_NODEV` if STPMIC driver is not ready.
+ * `STPMIC_RET_TIMEOUT` if timeout reached.
+ */
+stpmic_ret_t stpmic_ctx_interrupt_write_source(stpmic_ctx_t* ctx, uint32_t bitmap);
+
+/**
+ * interrupt handler, called by `stpmic_ctx_interrupt_dispatch` with the lock held.
+ * driver APIs can be called from it.
+ * @param flag `STPMIC_INTFLAG_xxx` flag that is pending.
+ * @return 1 to acknowledge (clear) the flag, 0 to keep it pending.
+ */
+typedef uint8_t (*stpmic_irq_handler_t)(stpmic_ctx_t* ctx, uint32_t flag, void* arg);
+
+/**
+ * read pending interrupts, call handlers of them and clear acknowledged ones.
+ * `handlers` is indexed by the bit number of `STPMIC_INTFLAG_xxx`, e.g. `[9]` for `STPMIC_INTFLAG_BUCK2_OCP`,
+ * and has `STPMIC_INTFLAG_COUNT` entries. NULL entries are skipped and their flags are kept pending.
+ * pending registers are read by a single burst and acknowledged flags are cleared by another.
+ * with the event log, pending flags are logged and ones over their rate limits are cleared without handlers.
+ * with the overcurrent policy, responses are executed before handlers and their flags are cleared.
+ * @param out acknowledged flags, nullable.
+ * @return
+ * `STPMIC_RET_NODEV` if STPMIC driver is not ready.
+ * `STPMIC_RET_INVALID` if `handlers` is NULL.
+ * `STPMIC_RET_TIMEOUT` if timeout reached.
+ */
+stpmic_ret_t stpmic_ctx_interrupt_dispatch(
+    stpmic_ctx_t* ctx, const stpmic_irq_handler_t* handlers, void* arg, uint32_t* out);
+
+#if STPMIC_IRQ_RING
+/**
+ * notify an assertion of INTn, safe to call from the interrupt handler.
+ * available if `STPMIC_IRQ_RING` is set to a power of 2, e.g. `-DSTPMIC_IRQ_RING=8`.
+ * this doesn't access the bus and doesn't take the lock, it only pushes `stamp` to the ring.
+ * only one interrupt handler can notify a context.
+ * @param stamp timestamp of the interrupt, any value to measure the latency by `irq.since`.
+ * @return
+ * `STPMIC_RET_BUSY` if the ring is full: counted by `irq.overflows`,
+ * flags are not lost because `stpmic_ctx_irq_service` reads all pending flags at once.
+ */
+stpmic_ret_t stpmic_ctx_irq_notify(stpmic_ctx_t* ctx, uint32_t stamp);
+
+/**
+ * serve notifications pushed by `stpmic_ctx_irq_notify`, from the task context.
+ * if any is queued, pending flags are dispatched once by `stpmic_ctx_interrupt_dispatch`
+ * for all of them, otherwise this returns without bus access.
+ * notifications are kept if the dispatch fails, and served again by the next call.
+ * @param out acknowledged flags, nullable.
+ * @return
+ * `STPMIC_RET_NODEV` if STPMIC driver is not ready.
+ * `STPMIC_RET_INVALID` if `handlers` is NULL.
+ * `STPMIC_RET_TIMEOUT` if timeout reached.
+ */
+stpmic_ret_t stpmic_ctx_irq_service(
+    stpmic_ctx_t* ctx, const stpmic_irq_handler_t* handlers, void* arg, uint32_t* out);
+#endif
+
+#if STPMIC_EVLOG_SIZE
+/**
+ * set up the event log of `stpmic_ctx_interrupt_dispatch`, the log is emptied.
+ * @param in settings, NULL to stop.
+ * @return
+ * `STPMIC_RET_NOTSUP` if no tick source is available.
+ */
+stpmic_ret_t stpmic_ctx_evlog_setup(stpmic_ctx_t* ctx, const stpmic_evlog_t* in);
+
+/**
+ * read and remove the oldest entries of the event log.
+ * an entry that is read isn't coalesced anymore, later occurrences start a new entry.
+ * @param out entries, oldest first.
+ * @param max capacity of `out`.
+ * @param count count of entries read, nullable.
+ * @return
+ * `STPMIC_RET_INVALID` if `out` is NULL.
+ */
+stpmic_ret_t stpmic_ctx_evlog_read(stpmic_ctx_t* ctx, stpmic_event_t* out, uint8_t max, uint8_t* count);
+#endif
+
+#if STPMIC_USE_OCP_POLICY
+/**
+ * set up the overcurrent policy, executed by `stpmic_ctx_interrupt_dispatch`.
+ * control registers of the rails are loaded to the cache here if not cached yet,
+ * so a response costs a single write without reads.
+ * @param in policy, NULL to stop. retries are reset.
+ * @return
+ * `STPMIC_RET_NODEV` if STPMIC driver is not ready.
+ * `STPMIC_RET_INVALID` if a rule is out of range.
+ * `STPMIC_RET_NOTSUP` if SWOUT is to be disabled, or no tick source is available for `STPMIC_OCP_RETRY`.
+ * `STPMIC_RET_TIMEOUT` if timeout reached.
+ */
+stpmic_ret_t stpmic_ctx_ocp_setup(stpmic_ctx_t* ctx, const stpmic_ocp_policy_t* in);
 
 /**
- * write interrupt sources. 
+ * enable rails again whose backoff has elapsed, call this periodically while retries are waiting.
+ * @param next milliseconds to the next retry, `0xffffffff` if none is waiting, nullable.
  * @return
  * `STPMIC_RET_NODEV` if STPMIC driver is not ready.
+ * `STPMIC_RET_DISABLED` if the policy is not set up.
  * `STPMIC_RET_TIMEOUT` if timeout reached.
  */
-stpmic_ret_t stpmic_interrupt_write_source(uint32_t bitmap);
+stpmic_ret_t stpmic_ctx_ocp_poll(stpmic_ctx_t* ctx, uint32_t* next);
+#endif
 
 /**
  * test whether the NVM controller is busy or not.
@@ -1657,7 +2552,7 @@ stpmic_ret_t stpmic_interrupt_write_source(uint32_t bitmap);
  * `STPMIC_RET_TIMEOUT` if timeout reached.
  * `STPMIC_RET_BUSY` if NVM controller is busy.
  */
-stpmic_ret_t stpmic_nvm_is_busy();
+stpmic_ret_t stpmic_ctx_nvm_is_busy(stpmic_ctx_t* ctx);
 
 /* NVM commands. */
 typedef enum {
@@ -1671,8 +2566,8 @@ typedef enum {
  * `STPMIC_RET_NODEV` if STPMIC driver is not ready.
  * `STPMIC_RET_TIMEOUT` if timeout reached.
  */
-static inline stpmic_ret_t stpmic_nvm_exec_cmd(stpmic_nvmcmd_t cmd) {
-    return stpmic_write_direct(STPMIC_REG_NVM_CR, cmd & 0x03u);
+static inline stpmic_ret_t stpmic_ctx_nvm_exec_cmd(stpmic_ctx_t* ctx, stpmic_nvmcmd_t cmd) {
+    return stpmic_ctx_write_direct(ctx, STPMIC_REG_NVM_CR, cmd & 0x03u);
 }
 
 /* VINOK_HYS. */
@@ -1771,7 +2666,7 @@ typedef struct {
  * `STPMIC_RET_NODEV` if STPMIC driver is not ready.
  * `STPMIC_RET_TIMEOUT` if timeout reached.
  */
-stpmic_ret_t stpmic_nvm_read(stpmic_nvmregs_t* out);
+stpmic_ret_t stpmic_ctx_nvm_read(stpmic_ctx_t* ctx, stpmic_nvmregs_t* out);
 
 /**
  * write NVM shadow registers. this does not program immediately.
@@ -1779,7 +2674,7 @@ stpmic_ret_t stpmic_nvm_read(stpmic_nvmregs_t* out);
  * `STPMIC_RET_NODEV` if STPMIC driver is not ready.
  * `STPMIC_RET_TIMEOUT` if timeout reached.
  */
-stpmic_ret_t stpmic_nvm_write(stpmic_nvmregs_t* in);
+stpmic_ret_t stpmic_ctx_nvm_write(stpmic_ctx_t* ctx, stpmic_nvmregs_t* in);
 
 /**
  * wait the NVM controller to be not busy.
@@ -1787,7 +2682,7 @@ stpmic_ret_t stpmic_nvm_write(stpmic_nvmregs_t* in);
  * `STPMIC_RET_NODEV` if STPMIC driver is not ready.
  * `STPMIC_RET_TIMEOUT` if timeout reached.
  */
-stpmic_ret_t stpmic_nvm_wait();
+stpmic_ret_t stpmic_ctx_nvm_wait(stpmic_ctx_t* ctx);
 
 /**
  * program the NVM once. 
@@ -1795,7 +2690,7 @@ stpmic_ret_t stpmic_nvm_wait();
  * `STPMIC_RET_NODEV` if STPMIC driver is not ready.
  * `STPMIC_RET_TIMEOUT` if timeout reached.
  */
-stpmic_ret_t stpmic_nvm_program();
+stpmic_ret_t stpmic_ctx_nvm_program(stpmic_ctx_t* ctx);
 
 /**
  * reload the NVM once. this discards all shadow register changes in STPMIC.
@@ -1803,7 +2698,32 @@ stpmic_ret_t stpmic_nvm_program();
  * `STPMIC_RET_NODEV` if STPMIC driver is not ready.
  * `STPMIC_RET_TIMEOUT` if timeout reached.
  */
-stpmic_ret_t stpmic_nvm_reload();
+stpmic_ret_t stpmic_ctx_nvm_reload(stpmic_ctx_t* ctx);
+
+/**
+ * program the NVM once, within the budget.
+ * if the budget was exhausted while programming, the NVM controller may be still busy.
+ * @param budget total time budget in milliseconds.
+ * @param out progress of the operation, nullable.
+ * @return
+ * `STPMIC_RET_NODEV` if STPMIC driver is not ready.
+ * `STPMIC_RET_NOTSUP` if no tick source is available.
+ * `STPMIC_RET_TIMEOUT` if timeout reached.
+ * `STPMIC_RET_DEADLINE` if the budget was exhausted.
+ */
+stpmic_ret_t stpmic_ctx_nvm_program_within(stpmic_ctx_t* ctx, uint32_t budget, stpmic_progress_t* out);
+
+/**
+ * reload the NVM once, within the budget.
+ * @param budget total time budget in milliseconds.
+ * @param out progress of the operation, nullable.
+ * @return
+ * `STPMIC_RET_NODEV` if STPMIC driver is not ready.
+ * `STPMIC_RET_NOTSUP` if no tick source is available.
+ * `STPMIC_RET_TIMEOUT` if timeout reached.
+ * `STPMIC_RET_DEADLINE` if the budget was exhausted.
+ */
+stpmic_ret_t stpmic_ctx_nvm_reload_within(stpmic_ctx_t* ctx, uint32_t budget, stpmic_progress_t* out);
 
 /* NVM_MAIN_CTRL_SHR. */
 typedef struct {
@@ -2114,6 +3034,616 @@ static inline void stpmic_nvm_set_i2c_addr(
     }
 }
 
+#if STPMIC_USE_ASYNC
+/**
+ * notify the completion of the current asynchronous transfer.
+ * @param ret `STPMIC_RET_OK` if succeed, or error code.
+ */
+void stpmic_ctx_async_complete(stpmic_ctx_t* ctx, stpmic_ret_t ret);
+
+/* test whether an asynchronous operation is in flight or not. */
+uint8_t stpmic_ctx_async_busy(stpmic_ctx_t* ctx);
+
+/**
+ * asynchronous operations.
+ * only one operation can be in flight, and blocking APIs return `STPMIC_RET_BUSY` until it completes.
+ * if nothing should be transferred (e.g. cache hit), `cb` is called before return.
+ * @return
+ * `STPMIC_RET_NODEV` if STPMIC driver is not ready.
+ * `STPMIC_RET_BUSY` if another asynchronous operation is in flight.
+ * `STPMIC_RET_NOTSUP` if the I2C channel has no `xfer_async`, or `reg` of `stpmic_ctx_write_async` is read-only.
+ * `STPMIC_RET_TIMEOUT` if the transfer couldn't be started.
+ * `cb` is not called if the operation couldn't be started.
+ */
+stpmic_ret_t stpmic_ctx_read_async(stpmic_ctx_t* ctx, stpmic_regid_t reg, stpmic_reg_t* out, stpmic_async_cb_t cb, void* arg);
+stpmic_ret_t stpmic_ctx_write_async(stpmic_ctx_t* ctx, stpmic_regid_t reg, stpmic_reg_t val, stpmic_async_cb_t cb, void* arg);
+
+/* `len` must not exceed 16. */
+stpmic_ret_t stpmic_ctx_read_burst_async(stpmic_ctx_t* ctx, stpmic_regid_t reg, stpmic_reg_t* out, uint8_t len, stpmic_async_cb_t cb, void* arg);
+stpmic_ret_t stpmic_ctx_write_burst_async(stpmic_ctx_t* ctx, stpmic_regid_t reg, const stpmic_reg_t* in, uint8_t len, stpmic_async_cb_t cb, void* arg);
+
+/* setup the specified buck converter, asynchronously. `opts` can be released after return. */
+stpmic_ret_t __stpmic_ctx_buck_setup_async(stpmic_ctx_t* ctx, uint8_t nth, uint8_t alt, stpmic_buck_t* opts, stpmic_async_cb_t cb, void* arg);
+
+/* enable or disable the specified buck converter, asynchronously. `STPMIC_RET_ALREADY` is passed to `cb`. */
+stpmic_ret_t __stpmic_ctx_buck_enable_async(stpmic_ctx_t* ctx, uint8_t nth, uint8_t alt, uint8_t enable, stpmic_async_cb_t cb, void* arg);
+
+/* setup the specified LDO, asynchronously. `opts` can be released after return. */
+stpmic_ret_t __stpmic_ctx_ldo_setup_async(stpmic_ctx_t* ctx, uint8_t nth, uint8_t alt, stpmic_ldo_t* opts, stpmic_async_cb_t cb, void* arg);
+
+/* enable or disable the specified LDO, asynchronously. `STPMIC_RET_ALREADY` is passed to `cb`. */
+stpmic_ret_t __stpmic_ctx_ldo_enable_async(stpmic_ctx_t* ctx, uint8_t nth, uint8_t alt, uint8_t enable, stpmic_async_cb_t cb, void* arg);
+
+static inline stpmic_ret_t stpmic_ctx_buck_setup_async(stpmic_ctx_t* ctx, uint8_t nth, stpmic_buck_t* opts, stpmic_async_cb_t cb, void* arg) {
+    return __stpmic_ctx_buck_setup_async(ctx, nth, 0, opts, cb, arg);
+}
+
+static inline stpmic_ret_t stpmic_ctx_buck_alt_setup_async(stpmic_ctx_t* ctx, uint8_t nth, stpmic_buck_t* opts, stpmic_async_cb_t cb, void* arg) {
+    return __stpmic_ctx_buck_setup_async(ctx, nth, 1, opts, cb, arg);
+}
+
+static inline stpmic_ret_t stpmic_ctx_buck_enable_async(stpmic_ctx_t* ctx, uint8_t nth, stpmic_async_cb_t cb, void* arg) {
+    return __stpmic_ctx_buck_enable_async(ctx, nth, 0, 1, cb, arg);
+}
+
+static inline stpmic_ret_t stpmic_ctx_buck_disable_async(stpmic_ctx_t* ctx, uint8_t nth, stpmic_async_cb_t cb, void* arg) {
+    return __stpmic_ctx_buck_enable_async(ctx, nth, 0, 0, cb, arg);
+}
+
+static inline stpmic_ret_t stpmic_ctx_ldo_setup_async(stpmic_ctx_t* ctx, uint8_t nth, stpmic_ldo_t* opts, stpmic_async_cb_t cb, void* arg) {
+    return __stpmic_ctx_ldo_setup_async(ctx, nth, 0, opts, cb, arg);
+}
+
+static inline stpmic_ret_t stpmic_ctx_ldo_alt_setup_async(stpmic_ctx_t* ctx, uint8_t nth, stpmic_ldo_t* opts, stpmic_async_cb_t cb, void* arg) {
+    return __stpmic_ctx_ldo_setup_async(ctx, nth, 1, opts, cb, arg);
+}
+
+static inline stpmic_ret_t stpmic_ctx_ldo_enable_async(stpmic_ctx_t* ctx, uint8_t nth, stpmic_async_cb_t cb, void* arg) {
+    return __stpmic_ctx_ldo_enable_async(ctx, nth, 0, 1, cb, arg);
+}
+
+static inline stpmic_ret_t stpmic_ctx_ldo_disable_async(stpmic_ctx_t* ctx, uint8_t nth, stpmic_async_cb_t cb, void* arg) {
+    return __stpmic_ctx_ldo_enable_async(ctx, nth, 0, 0, cb, arg);
+}
+
+/* read `INT_PENDING_Rx` registers, asynchronously. `out` must be valid until `cb` is called. */
+stpmic_ret_t stpmic_ctx_interrupt_pending_async(stpmic_ctx_t* ctx, uint32_t* out, stpmic_async_cb_t cb, void* arg);
+
+/* clear interrupts, asynchronously. */
+stpmic_ret_t stpmic_ctx_interrupt_clear_async(stpmic_ctx_t* ctx, uint32_t bitmap, stpmic_async_cb_t cb, void* arg);
+#endif
+
+/**
+ * APIs of the default context, same with `stpmic_ctx_xxx` APIs with `STPMIC_CTX_DEFAULT`.
+ */
+static inline void stpmic_set_timeout(stpmic_timeout_t* in) {
+    stpmic_ctx_set_timeout(STPMIC_CTX_DEFAULT, in);
+}
+
+static inline void stpmic_get_timeout(stpmic_timeout_t* out) {
+    stpmic_ctx_get_timeout(STPMIC_CTX_DEFAULT, out);
+}
+
+#if STPMIC_USE_LOCK
+static inline void stpmic_set_lock(const stpmic_lock_t* in) {
+    stpmic_ctx_set_lock(STPMIC_CTX_DEFAULT, in);
+}
+
+static inline void stpmic_lock(void) {
+    stpmic_ctx_lock(STPMIC_CTX_DEFAULT);
+}
+
+static inline void stpmic_unlock(void) {
+    stpmic_ctx_unlock(STPMIC_CTX_DEFAULT);
+}
+#endif
+
+#if STPMIC_USE_RETAIN
+static inline stpmic_ret_t stpmic_set_retain(stpmic_retain_t* area, uint32_t gen) {
+    return stpmic_ctx_set_retain(STPMIC_CTX_DEFAULT, area, gen);
+}
+#endif
+
+#if STPMIC_USE_CUSTOM
+static inline stpmic_ret_t stpmic_init(int16_t addr) {
+    return stpmic_ctx_init(STPMIC_CTX_DEFAULT, addr);
+}
+#else
+static inline stpmic_ret_t stpmic_init(stpmic_i2c_t* dev, int16_t addr) {
+    return stpmic_ctx_init(STPMIC_CTX_DEFAULT, dev, addr);
+}
+#endif
+
+static inline stpmic_ret_t stpmic_deinit() {
+    return stpmic_ctx_deinit(STPMIC_CTX_DEFAULT);
+}
+
+static inline stpmic_ret_t stpmic_read_direct(stpmic_regid_t reg, stpmic_reg_t* out) {
+    return stpmic_ctx_read_direct(STPMIC_CTX_DEFAULT, reg, out);
+}
+
+static inline stpmic_ret_t stpmic_read_burst(stpmic_regid_t reg, stpmic_reg_t* out, uint8_t len) {
+    return stpmic_ctx_read_burst(STPMIC_CTX_DEFAULT, reg, out, len);
+}
+
+static inline stpmic_ret_t stpmic_write_direct(stpmic_regid_t reg, stpmic_reg_t val) {
+    return stpmic_ctx_write_direct(STPMIC_CTX_DEFAULT, reg, val);
+}
+
+static inline stpmic_ret_t stpmic_write_burst(stpmic_regid_t reg, const stpmic_reg_t* in, uint8_t len) {
+    return stpmic_ctx_write_burst(STPMIC_CTX_DEFAULT, reg, in, len);
+}
+
+static inline stpmic_ret_t stpmic_read(stpmic_regid_t reg, stpmic_reg_t* out) {
+    return stpmic_ctx_read(STPMIC_CTX_DEFAULT, reg, out);
+}
+
+static inline stpmic_ret_t stpmic_write(stpmic_regid_t reg, stpmic_reg_t val) {
+    return stpmic_ctx_write(STPMIC_CTX_DEFAULT, reg, val);
+}
+
+static inline stpmic_ret_t stpmic_update_bits(stpmic_regid_t reg, stpmic_reg_t mask, stpmic_reg_t val) {
+    return stpmic_ctx_update_bits(STPMIC_CTX_DEFAULT, reg, mask, val);
+}
+
+static inline stpmic_ret_t stpmic_clear_cache(stpmic_regid_t reg) {
+    return stpmic_ctx_clear_cache(STPMIC_CTX_DEFAULT, reg);
+}
+
+static inline stpmic_ret_t stpmic_batch_write(stpmic_regid_t reg, stpmic_reg_t val) {
+    return stpmic_ctx_batch_write(STPMIC_CTX_DEFAULT, reg, val);
+}
+
+static inline stpmic_ret_t stpmic_batch_flush() {
+    return stpmic_ctx_batch_flush(STPMIC_CTX_DEFAULT);
+}
+
+static inline stpmic_ret_t stpmic_reload_cache() {
+    return stpmic_ctx_reload_cache(STPMIC_CTX_DEFAULT);
+}
+
+static inline stpmic_ret_t stpmic_deadline_begin(uint32_t budget) {
+    return stpmic_ctx_deadline_begin(STPMIC_CTX_DEFAULT, budget);
+}
+
+static inline stpmic_ret_t stpmic_deadline_end(stpmic_progress_t* out) {
+    return stpmic_ctx_deadline_end(STPMIC_CTX_DEFAULT, out);
+}
+
+static inline stpmic_ret_t stpmic_txn_begin() {
+    return stpmic_ctx_txn_begin(STPMIC_CTX_DEFAULT);
+}
+
+static inline stpmic_ret_t stpmic_txn_write(stpmic_regid_t reg, stpmic_reg_t val) {
+    return stpmic_ctx_txn_write(STPMIC_CTX_DEFAULT, reg, val);
+}
+
+static inline stpmic_ret_t stpmic_txn_update_bits(stpmic_regid_t reg, stpmic_reg_t mask, stpmic_reg_t val) {
+    return stpmic_ctx_txn_update_bits(STPMIC_CTX_DEFAULT, reg, mask, val);
+}
+
+static inline stpmic_ret_t stpmic_txn_commit() {
+    return stpmic_ctx_txn_commit(STPMIC_CTX_DEFAULT);
+}
+
+static inline stpmic_ret_t stpmic_txn_abort() {
+    return stpmic_ctx_txn_abort(STPMIC_CTX_DEFAULT);
+}
+
+static inline stpmic_ret_t stpmic_restart_check(uint8_t* out) {
+    return stpmic_ctx_restart_check(STPMIC_CTX_DEFAULT, out);
+}
+
+#if STPMIC_USE_RECONCILE
+static inline stpmic_ret_t stpmic_reconcile_setup(const stpmic_reconcile_t* in) {
+    return stpmic_ctx_reconcile_setup(STPMIC_CTX_DEFAULT, in);
+}
+
+static inline stpmic_ret_t stpmic_reconcile(void) {
+    return stpmic_ctx_reconcile(STPMIC_CTX_DEFAULT);
+}
+#endif
+
+static inline stpmic_ret_t stpmic_batch_flush_within(uint32_t budget, stpmic_progress_t* out) {
+    return stpmic_ctx_batch_flush_within(STPMIC_CTX_DEFAULT, budget, out);
+}
+
+static inline stpmic_ret_t stpmic_reload_cache_within(uint32_t budget, stpmic_progress_t* out) {
+    return stpmic_ctx_reload_cache_within(STPMIC_CTX_DEFAULT, budget, out);
+}
+
+static inline stpmic_ret_t stpmic_version(stpmic_version_t* out) {
+    return stpmic_ctx_version(STPMIC_CTX_DEFAULT, out);
+}
+
+static inline stpmic_ret_t stpmic_tonsr(stpmic_reg_t* out) {
+    return stpmic_ctx_tonsr(STPMIC_CTX_DEFAULT, out);
+}
+
+static inline stpmic_ret_t stpmic_tofsr(stpmic_reg_t* out) {
+    return stpmic_ctx_tofsr(STPMIC_CTX_DEFAULT, out);
+}
+
+static inline stpmic_ret_t stpmic_ocpldosr(stpmic_reg_t* out) {
+    return stpmic_ctx_ocpldosr(STPMIC_CTX_DEFAULT, out);
+}
+
+static inline stpmic_ret_t stpmic_ocpbucksbsw(stpmic_reg_t* out) {
+    return stpmic_ctx_ocpbucksbsw(STPMIC_CTX_DEFAULT, out);
+}
+
+static inline stpmic_ret_t stpmic_restartsr(stpmic_reg_t* out) {
+    return stpmic_ctx_restartsr(STPMIC_CTX_DEFAULT, out);
+}
+
+static inline uint8_t stpmic_opmode_is_main() {
+    return stpmic_ctx_opmode_is_main(STPMIC_CTX_DEFAULT);
+}
+
+static inline uint8_t stpmic_ldo4_src(stpmic_reg_t in) {
+    return stpmic_ctx_ldo4_src(STPMIC_CTX_DEFAULT, in);
+}
+
+static inline stpmic_ret_t stpmic_maincr(stpmic_reg_t* out) {
+    return stpmic_ctx_maincr(STPMIC_CTX_DEFAULT, out);
+}
+
+static inline stpmic_ret_t stpmic_request_swoff() {
+    return stpmic_ctx_request_swoff(STPMIC_CTX_DEFAULT);
+}
+
+static inline stpmic_ret_t stpmic_padspullcr(stpmic_reg_t* out) {
+    return stpmic_ctx_padspullcr(STPMIC_CTX_DEFAULT, out);
+}
+
+static inline stpmic_ret_t stpmic_pwrctrl_init(stpmic_pwrctrl_t* pwrctrl) {
+    return stpmic_ctx_pwrctrl_init(STPMIC_CTX_DEFAULT, pwrctrl);
+}
+
+static inline stpmic_ret_t stpmic_pwrctrl_enable() {
+    return stpmic_ctx_pwrctrl_enable(STPMIC_CTX_DEFAULT);
+}
+
+static inline stpmic_ret_t stpmic_pwrctrl_disable() {
+    return stpmic_ctx_pwrctrl_disable(STPMIC_CTX_DEFAULT);
+}
+
+static inline stpmic_ret_t stpmic_pwrctrl_deinit() {
+    return stpmic_ctx_pwrctrl_deinit(STPMIC_CTX_DEFAULT);
+}
+
+static inline stpmic_ret_t stpmic_wakeup_init(stpmic_wakeup_t* wakeup) {
+    return stpmic_ctx_wakeup_init(STPMIC_CTX_DEFAULT, wakeup);
+}
+
+static inline stpmic_ret_t stpmic_wakeup_deinit() {
+    return stpmic_ctx_wakeup_deinit(STPMIC_CTX_DEFAULT);
+}
+
+static inline stpmic_ret_t stpmic_buckspd(stpmic_reg_t* out) {
+    return stpmic_ctx_buckspd(STPMIC_CTX_DEFAULT, out);
+}
+
+static inline stpmic_ret_t stpmic_ldo1234pd(stpmic_reg_t* out) {
+    return stpmic_ctx_ldo1234pd(STPMIC_CTX_DEFAULT, out);
+}
+
+static inline stpmic_ret_t stpmic_ldo56pd(stpmic_reg_t* out) {
+    return stpmic_ctx_ldo56pd(STPMIC_CTX_DEFAULT, out);
+}
+
+static inline stpmic_ret_t stpmic_swvincr(stpmic_reg_t* out) {
+    return stpmic_ctx_swvincr(STPMIC_CTX_DEFAULT, out);
+}
+
+static inline stpmic_ret_t stpmic_pkeytofcr(stpmic_reg_t* out) {
+    return stpmic_ctx_pkeytofcr(STPMIC_CTX_DEFAULT, out);
+}
+
+static inline stpmic_ret_t stpmic_mrst(uint16_t* out) {
+    return stpmic_ctx_mrst(STPMIC_CTX_DEFAULT, out);
+}
+
+static inline stpmic_ret_t stpmic_set_mrst(uint16_t val) {
+    return stpmic_ctx_set_mrst(STPMIC_CTX_DEFAULT, val);
+}
+
+static inline stpmic_ret_t stpmic_watchdog_deinit() {
+    return stpmic_ctx_watchdog_deinit(STPMIC_CTX_DEFAULT);
+}
+
+static inline stpmic_ret_t stpmic_watchdog_init(uint8_t sec) {
+    return stpmic_ctx_watchdog_init(STPMIC_CTX_DEFAULT, sec);
+}
+
+static inline stpmic_ret_t stpmic_watchdog_reset() {
+    return stpmic_ctx_watchdog_reset(STPMIC_CTX_DEFAULT);
+}
+
+static inline stpmic_ret_t stpmic_buck_main_cr(uint8_t nth, stpmic_reg_t* out) {
+    return stpmic_ctx_buck_main_cr(STPMIC_CTX_DEFAULT, nth, out);
+}
+
+static inline stpmic_ret_t stpmic_buck_alt_cr(uint8_t nth, stpmic_reg_t* out) {
+    return stpmic_ctx_buck_alt_cr(STPMIC_CTX_DEFAULT, nth, out);
+}
+
+static inline stpmic_ret_t __stpmic_buck_setup(uint8_t nth, uint8_t alt, stpmic_buck_t* opts) {
+    return __stpmic_ctx_buck_setup(STPMIC_CTX_DEFAULT, nth, alt, opts);
+}
+
+static inline stpmic_ret_t stpmic_buck_setup(uint8_t nth, stpmic_buck_t* opts) {
+    return stpmic_ctx_buck_setup(STPMIC_CTX_DEFAULT, nth, opts);
+}
+
+static inline stpmic_ret_t stpmic_buck_alt_setup(uint8_t nth, stpmic_buck_t* opts) {
+    return stpmic_ctx_buck_alt_setup(STPMIC_CTX_DEFAULT, nth, opts);
+}
+
+static inline stpmic_ret_t __stpmic_buck_enable(uint8_t nth, uint8_t alt) {
+    return __stpmic_ctx_buck_enable(STPMIC_CTX_DEFAULT, nth, alt);
+}
+
+static inline stpmic_ret_t stpmic_buck_enable(uint8_t nth) {
+    return stpmic_ctx_buck_enable(STPMIC_CTX_DEFAULT, nth);
+}
+
+static inline stpmic_ret_t stpmic_buck_alt_enable(uint8_t nth, uint8_t alt) {
+    return stpmic_ctx_buck_alt_enable(STPMIC_CTX_DEFAULT, nth, alt);
+}
+
+static inline stpmic_ret_t __stpmic_buck_disable(uint8_t nth, uint8_t alt) {
+    return __stpmic_ctx_buck_disable(STPMIC_CTX_DEFAULT, nth, alt);
+}
+
+static inline stpmic_ret_t stpmic_buck_disable(uint8_t nth) {
+    return stpmic_ctx_buck_disable(STPMIC_CTX_DEFAULT, nth);
+}
+
+static inline stpmic_ret_t stpmic_buck_alt_disable(uint8_t nth, uint8_t alt) {
+    return stpmic_ctx_buck_alt_disable(STPMIC_CTX_DEFAULT, nth, alt);
+}
+
+static inline stpmic_ret_t __stpmic_ldo_setup(uint8_t nth, uint8_t alt, stpmic_ldo_t* opts) {
+    return __stpmic_ctx_ldo_setup(STPMIC_CTX_DEFAULT, nth, alt, opts);
+}
+
+static inline stpmic_ret_t stpmic_ldo_setup(uint8_t nth, stpmic_ldo_t* opts) {
+    return stpmic_ctx_ldo_setup(STPMIC_CTX_DEFAULT, nth, opts);
+}
+
+static inline stpmic_ret_t stpmic_ldo_alt_setup(uint8_t nth, stpmic_ldo_t* opts) {
+    return stpmic_ctx_ldo_alt_setup(STPMIC_CTX_DEFAULT, nth, opts);
+}
+
+static inline stpmic_ret_t __stpmic_ldo_enable(uint8_t nth, uint8_t alt) {
+    return __stpmic_ctx_ldo_enable(STPMIC_CTX_DEFAULT, nth, alt);
+}
+
+static inline stpmic_ret_t stpmic_ldo_enable(uint8_t nth) {
+    return stpmic_ctx_ldo_enable(STPMIC_CTX_DEFAULT, nth);
+}
+
+static inline stpmic_ret_t stpmic_ldo_alt_enable(uint8_t nth) {
+    return stpmic_ctx_ldo_alt_enable(STPMIC_CTX_DEFAULT, nth);
+}
+
+static inline stpmic_ret_t __stpmic_ldo_disable(uint8_t nth, uint8_t alt) {
+    return __stpmic_ctx_ldo_disable(STPMIC_CTX_DEFAULT, nth, alt);
+}
+
+static inline stpmic_ret_t stpmic_ldo_disable(uint8_t nth) {
+    return stpmic_ctx_ldo_disable(STPMIC_CTX_DEFAULT, nth);
+}
+
+static inline stpmic_ret_t stpmic_ldo_alt_disable(uint8_t nth) {
+    return stpmic_ctx_ldo_alt_disable(STPMIC_CTX_DEFAULT, nth);
+}
+
+static inline stpmic_ret_t __stpmic_refddr_enable(uint8_t alt) {
+    return __stpmic_ctx_refddr_enable(STPMIC_CTX_DEFAULT, alt);
+}
+
+static inline stpmic_ret_t stpmic_refddr_enable() {
+    return stpmic_ctx_refddr_enable(STPMIC_CTX_DEFAULT);
+}
+
+static inline stpmic_ret_t stpmic_refddr_alt_enable() {
+    return stpmic_ctx_refddr_alt_enable(STPMIC_CTX_DEFAULT);
+}
+
+static inline stpmic_ret_t __stpmic_refddr_disable(uint8_t alt) {
+    return __stpmic_ctx_refddr_disable(STPMIC_CTX_DEFAULT, alt);
+}
+
+static inline stpmic_ret_t stpmic_refddr_disable() {
+    return stpmic_ctx_refddr_disable(STPMIC_CTX_DEFAULT);
+}
+
+static inline stpmic_ret_t stpmic_refddr_alt_disable() {
+    return stpmic_ctx_refddr_alt_disable(STPMIC_CTX_DEFAULT);
+}
+
+static inline stpmic_ret_t stpmic_interrupt_pending(uint32_t* out) {
+    return stpmic_ctx_interrupt_pending(STPMIC_CTX_DEFAULT, out);
+}
+
+static inline stpmic_ret_t stpmic_interrupt_clear(uint32_t bitmap) {
+    return stpmic_ctx_interrupt_clear(STPMIC_CTX_DEFAULT, bitmap);
+}
+
+static inline stpmic_ret_t stpmic_interrupt_read_mask(uint32_t* out) {
+    return stpmic_ctx_interrupt_read_mask(STPMIC_CTX_DEFAULT, out);
+}
+
+static inline stpmic_ret_t stpmic_interrupt_mask_set(uint32_t bitmap) {
+    return stpmic_ctx_interrupt_mask_set(STPMIC_CTX_DEFAULT, bitmap);
+}
+
+static inline stpmic_ret_t stpmic_interrupt_mask_clear(uint32_t bitmap) {
+    return stpmic_ctx_interrupt_mask_clear(STPMIC_CTX_DEFAULT, bitmap);
+}
+
+static inline stpmic_ret_t stpmic_interrupt_read_source(uint32_t* out) {
+    return stpmic_ctx_interrupt_read_source(STPMIC_CTX_DEFAULT, out);
+}
+
+static inline stpmic_ret_t stpmic_interrupt_write_source(uint32_t bitmap) {
+    return stpmic_ctx_interrupt_write_source(STPMIC_CTX_DEFAULT, bitmap);
+}
+
+static inline stpmic_ret_t stpmic_interrupt_dispatch(const stpmic_irq_handler_t* handlers, void* arg, uint32_t* out) {
+    return stpmic_ctx_interrupt_dispatch(STPMIC_CTX_DEFAULT, handlers, arg, out);
+}
+
+#if STPMIC_IRQ_RING
+static inline stpmic_ret_t stpmic_irq_notify(uint32_t stamp) {
+    return stpmic_ctx_irq_notify(STPMIC_CTX_DEFAULT, stamp);
+}
+
+static inline stpmic_ret_t stpmic_irq_service(const stpmic_irq_handler_t* handlers, void* arg, uint32_t* out) {
+    return stpmic_ctx_irq_service(STPMIC_CTX_DEFAULT, handlers, arg, out);
+}
+#endif
+
+#if STPMIC_EVLOG_SIZE
+static inline stpmic_ret_t stpmic_evlog_setup(const stpmic_evlog_t* in) {
+    return stpmic_ctx_evlog_setup(STPMIC_CTX_DEFAULT, in);
+}
+
+static inline stpmic_ret_t stpmic_evlog_read(stpmic_event_t* out, uint8_t max, uint8_t* count) {
+    return stpmic_ctx_evlog_read(STPMIC_CTX_DEFAULT, out, max, count);
+}
+#endif
+
+#if STPMIC_USE_OCP_POLICY
+static inline stpmic_ret_t stpmic_ocp_setup(const stpmic_ocp_policy_t* in) {
+    return stpmic_ctx_ocp_setup(STPMIC_CTX_DEFAULT, in);
+}
+
+static inline stpmic_ret_t stpmic_ocp_poll(uint32_t* next) {
+    return stpmic_ctx_ocp_poll(STPMIC_CTX_DEFAULT, next);
+}
+#endif
+
+static inline stpmic_ret_t stpmic_nvm_is_busy() {
+    return stpmic_ctx_nvm_is_busy(STPMIC_CTX_DEFAULT);
+}
+
+static inline stpmic_ret_t stpmic_nvm_exec_cmd(stpmic_nvmcmd_t cmd) {
+    return stpmic_ctx_nvm_exec_cmd(STPMIC_CTX_DEFAULT, cmd);
+}
+
+static inline stpmic_ret_t stpmic_nvm_read(stpmic_nvmregs_t* out) {
+    return stpmic_ctx_nvm_read(STPMIC_CTX_DEFAULT, out);
+}
+
+static inline stpmic_ret_t stpmic_nvm_write(stpmic_nvmregs_t* in) {
+    return stpmic_ctx_nvm_write(STPMIC_CTX_DEFAULT, in);
+}
+
+static inline stpmic_ret_t stpmic_nvm_wait() {
+    return stpmic_ctx_nvm_wait(STPMIC_CTX_DEFAULT);
+}
+
+static inline stpmic_ret_t stpmic_nvm_program() {
+    return stpmic_ctx_nvm_program(STPMIC_CTX_DEFAULT);
+}
+
+static inline stpmic_ret_t stpmic_nvm_reload() {
+    return stpmic_ctx_nvm_reload(STPMIC_CTX_DEFAULT);
+}
+
+static inline stpmic_ret_t stpmic_nvm_program_within(uint32_t budget, stpmic_progress_t* out) {
+    return stpmic_ctx_nvm_program_within(STPMIC_CTX_DEFAULT, budget, out);
+}
+
+static inline stpmic_ret_t stpmic_nvm_reload_within(uint32_t budget, stpmic_progress_t* out) {
+    return stpmic_ctx_nvm_reload_within(STPMIC_CTX_DEFAULT, budget, out);
+}
+
+#if STPMIC_USE_ASYNC
+static inline void stpmic_async_complete(stpmic_ret_t ret) {
+    stpmic_ctx_async_complete(STPMIC_CTX_DEFAULT, ret);
+}
+
+static inline uint8_t stpmic_async_busy() {
+    return stpmic_ctx_async_busy(STPMIC_CTX_DEFAULT);
+}
+
+static inline stpmic_ret_t stpmic_read_async(stpmic_regid_t reg, stpmic_reg_t* out, stpmic_async_cb_t cb, void* arg) {
+    return stpmic_ctx_read_async(STPMIC_CTX_DEFAULT, reg, out, cb, arg);
+}
+
+static inline stpmic_ret_t stpmic_write_async(stpmic_regid_t reg, stpmic_reg_t val, stpmic_async_cb_t cb, void* arg) {
+    return stpmic_ctx_write_async(STPMIC_CTX_DEFAULT, reg, val, cb, arg);
+}
+
+static inline stpmic_ret_t stpmic_read_burst_async(stpmic_regid_t reg, stpmic_reg_t* out, uint8_t len, stpmic_async_cb_t cb, void* arg) {
+    return stpmic_ctx_read_burst_async(STPMIC_CTX_DEFAULT, reg, out, len, cb, arg);
+}
+
+static inline stpmic_ret_t stpmic_write_burst_async(stpmic_regid_t reg, const stpmic_reg_t* in, uint8_t len, stpmic_async_cb_t cb, void* arg) {
+    return stpmic_ctx_write_burst_async(STPMIC_CTX_DEFAULT, reg, in, len, cb, arg);
+}
+
+static inline stpmic_ret_t __stpmic_buck_setup_async(uint8_t nth, uint8_t alt, stpmic_buck_t* opts, stpmic_async_cb_t cb, void* arg) {
+    return __stpmic_ctx_buck_setup_async(STPMIC_CTX_DEFAULT, nth, alt, opts, cb, arg);
+}
+
+static inline stpmic_ret_t __stpmic_buck_enable_async(uint8_t nth, uint8_t alt, uint8_t enable, stpmic_async_cb_t cb, void* arg) {
+    return __stpmic_ctx_buck_enable_async(STPMIC_CTX_DEFAULT, nth, alt, enable, cb, arg);
+}
+
+static inline stpmic_ret_t __stpmic_ldo_setup_async(uint8_t nth, uint8_t alt, stpmic_ldo_t* opts, stpmic_async_cb_t cb, void* arg) {
+    return __stpmic_ctx_ldo_setup_async(STPMIC_CTX_DEFAULT, nth, alt, opts, cb, arg);
+}
+
+static inline stpmic_ret_t __stpmic_ldo_enable_async(uint8_t nth, uint8_t alt, uint8_t enable, stpmic_async_cb_t cb, void* arg) {
+    return __stpmic_ctx_ldo_enable_async(STPMIC_CTX_DEFAULT, nth, alt, enable, cb, arg);
+}
+
+static inline stpmic_ret_t stpmic_buck_setup_async(uint8_t nth, stpmic_buck_t* opts, stpmic_async_cb_t cb, void* arg) {
+    return stpmic_ctx_buck_setup_async(STPMIC_CTX_DEFAULT, nth, opts, cb, arg);
+}
+
+static inline stpmic_ret_t stpmic_buck_alt_setup_async(uint8_t nth, stpmic_buck_t* opts, stpmic_async_cb_t cb, void* arg) {
+    return stpmic_ctx_buck_alt_setup_async(STPMIC_CTX_DEFAULT, nth, opts, cb, arg);
+}
+
+static inline stpmic_ret_t stpmic_buck_enable_async(uint8_t nth, stpmic_async_cb_t cb, void* arg) {
+    return stpmic_ctx_buck_enable_async(STPMIC_CTX_DEFAULT, nth, cb, arg);
+}
+
+static inline stpmic_ret_t stpmic_buck_disable_async(uint8_t nth, stpmic_async_cb_t cb, void* arg) {
+    return stpmic_ctx_buck_disable_async(STPMIC_CTX_DEFAULT, nth, cb, arg);
+}
+
+static inline stpmic_ret_t stpmic_ldo_setup_async(uint8_t nth, stpmic_ldo_t* opts, stpmic_async_cb_t cb, void* arg) {
+    return stpmic_ctx_ldo_setup_async(STPMIC_CTX_DEFAULT, nth, opts, cb, arg);
+}
+
+static inline stpmic_ret_t stpmic_ldo_alt_setup_async(uint8_t nth, stpmic_ldo_t* opts, stpmic_async_cb_t cb, void* arg) {
+    return stpmic_ctx_ldo_alt_setup_async(STPMIC_CTX_DEFAULT, nth, opts, cb, arg);
+}
+
+static inline stpmic_ret_t stpmic_ldo_enable_async(uint8_t nth, stpmic_async_cb_t cb, void* arg) {
+    return stpmic_ctx_ldo_enable_async(STPMIC_CTX_DEFAULT, nth, cb, arg);
+}
+
+static inline stpmic_ret_t stpmic_ldo_disable_async(uint8_t nth, stpmic_async_cb_t cb, void* arg) {
+    return stpmic_ctx_ldo_disable_async(STPMIC_CTX_DEFAULT, nth, cb, arg);
+}
+
+static inline stpmic_ret_t stpmic_interrupt_pending_async(uint32_t* out, stpmic_async_cb_t cb, void* arg) {
+    return stpmic_ctx_interrupt_pending_async(STPMIC_CTX_DEFAULT, out, cb, arg);
+}
+
+static inline stpmic_ret_t stpmic_interrupt_clear_async(uint32_t bitmap, stpmic_async_cb_t cb, void* arg) {
+    return stpmic_ctx_interrupt_clear_async(STPMIC_CTX_DEFAULT, bitmap, cb, arg);
+}
+#endif
+
 #ifdef __cplusplus
 }
 #endif
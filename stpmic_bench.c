@@ -0,0 +1,699 @@
+#include "stpmic_bench.h"
+#include <string.h>
+
+#if STPMIC_USE_CHAN
+/* bus clocks that the benchmark runs at. */
+const uint32_t STPMIC_BENCH_HZ[STPMIC_BENCH_CLOCKS] = {
+    100000, 400000, 1000000
+};
+
+/* initialize the driver on the simulated device, with all cached registers. */
+static stpmic_ret_t __stpmic_bench_init(stpmic_sim_t* sim) {
+    stpmic_ret_t ret = stpmic_init(&sim->chan, -1);
+
+#if STPMIC_LAZY_INIT
+    // --> measure APIs on the same cache state.
+    if (ret == STPMIC_RET_OK) {
+        ret = stpmic_reload_cache();
+    }
+#endif
+
+    return ret;
+}
+
+static stpmic_ret_t __stpmic_bench_run_init(stpmic_sim_t* sim) {
+    return stpmic_init(&sim->chan, -1);
+}
+
+#if STPMIC_USE_RETAIN
+static stpmic_retain_t __stpmic_bench_retain;
+
+/* initialize the driver with a retained image, then reset the MCU: the context is lost. */
+static stpmic_ret_t __stpmic_bench_warm_prepare(stpmic_sim_t* sim) {
+    stpmic_ret_t ret = stpmic_set_retain(&__stpmic_bench_retain, 1);
+
+    if (ret == STPMIC_RET_OK) {
+        ret = stpmic_init(&sim->chan, -1);
+    }
+
+    memset(STPMIC_CTX_DEFAULT, 0, sizeof(*STPMIC_CTX_DEFAULT));
+    return ret == STPMIC_RET_OK 
+        ? stpmic_set_retain(&__stpmic_bench_retain, 1) 
+        : ret;
+}
+
+static stpmic_ret_t __stpmic_bench_warm_init(stpmic_sim_t* sim) {
+    stpmic_ret_t ret = stpmic_init(&sim->chan, -1);
+
+    // --> fell back to the full reload.
+    if (ret == STPMIC_RET_OK && !STPMIC_CTX_DEFAULT->warm) {
+        return STPMIC_RET_UNKNOWN;
+    }
+
+    return ret;
+}
+#endif
+
+static stpmic_ret_t __stpmic_bench_reload_cache(stpmic_sim_t* sim) {
+    (void) sim;
+    return stpmic_reload_cache();
+}
+
+static stpmic_ret_t __stpmic_bench_read(stpmic_sim_t* sim) {
+    (void) sim;
+    stpmic_reg_t val;
+    return stpmic_read(STPMIC_REG_BUCK1_MAIN_CR, &val);
+}
+
+#if STPMIC_READ_AHEAD >= 3
+/* BUCK1 ~ BUCK4 are not cached, e.g. lazy init. */
+static stpmic_ret_t __stpmic_bench_miss_prepare(stpmic_sim_t* sim) {
+    stpmic_ret_t ret = __stpmic_bench_init(sim);
+
+    for (uint8_t i = 0; i < 4 && ret == STPMIC_RET_OK; ++i) {
+        ret = stpmic_clear_cache((stpmic_regid_t)(STPMIC_REG_BUCK1_MAIN_CR + i));
+    }
+
+    return ret;
+}
+
+/* a miss reads neighbours ahead, the rest should hit. */
+static stpmic_ret_t __stpmic_bench_read_miss(stpmic_sim_t* sim) {
+    (void) sim;
+    stpmic_ret_t ret = STPMIC_RET_OK;
+    stpmic_reg_t val;
+
+    for (uint8_t i = 0; i < 4 && ret == STPMIC_RET_OK; ++i) {
+        ret = stpmic_read((stpmic_regid_t)(STPMIC_REG_BUCK1_MAIN_CR + i), &val);
+    }
+
+    return ret;
+}
+#endif
+
+static stpmic_ret_t __stpmic_bench_read_direct(stpmic_sim_t* sim) {
+    (void) sim;
+    stpmic_reg_t val;
+    return stpmic_read_direct(STPMIC_REG_BUCK1_MAIN_CR, &val);
+}
+
+static stpmic_ret_t __stpmic_bench_write(stpmic_sim_t* sim) {
+    (void) sim;
+    return stpmic_write(STPMIC_REG_BUCK1_MAIN_CR, 0x55);
+}
+
+static stpmic_ret_t __stpmic_bench_update_bits(stpmic_sim_t* sim) {
+    (void) sim;
+    return stpmic_update_bits(STPMIC_REG_BUCK1_MAIN_CR, STPMIC_BIT_MASK(1), STPMIC_BIT_MASK(1));
+}
+
+/* the value is unchanged, nothing should be written. */
+static stpmic_ret_t __stpmic_bench_update_bits_same(stpmic_sim_t* sim) {
+    (void) sim;
+    return stpmic_update_bits(STPMIC_REG_BUCK1_MAIN_CR, STPMIC_BIT_MASK(1), 0);
+}
+
+#if STPMIC_USE_RECONCILE
+/* BUCK1_MAIN_CR is written, then drifts on the device. */
+static stpmic_ret_t __stpmic_bench_reconcile_prepare(stpmic_sim_t* sim) {
+    stpmic_reconcile_t opts = { .bus_hz = 400000, .duty = 1000, .burst = STPMIC_BURST_MAX };
+    stpmic_ret_t ret = __stpmic_bench_init(sim);
+
+    if (ret == STPMIC_RET_OK) {
+        ret = stpmic_write(STPMIC_REG_BUCK1_MAIN_CR, 0x55);
+    }
+
+    if (ret == STPMIC_RET_OK) {
+        ret = stpmic_reconcile_setup(&opts);
+    }
+
+    sim->regs[STPMIC_REG_BUCK1_MAIN_CR] = 0;
+    return ret;
+}
+
+static stpmic_ret_t __stpmic_bench_reconcile(stpmic_sim_t* sim) {
+    stpmic_ret_t ret = stpmic_reconcile();
+
+    // --> the drift should be repaired by a single call.
+    if (ret == STPMIC_RET_OK && sim->regs[STPMIC_REG_BUCK1_MAIN_CR] != 0x55) {
+        return STPMIC_RET_UNKNOWN;
+    }
+
+    return ret;
+}
+
+/* SWOFF is written with MAIN_CR, the device clears it. */
+static stpmic_ret_t __stpmic_bench_reconcile_cmd_prepare(stpmic_sim_t* sim) {
+    stpmic_reconcile_t opts = { .bus_hz = 400000, .duty = 1000, .burst = STPMIC_BURST_MAX };
+    stpmic_ret_t ret = __stpmic_bench_init(sim);
+
+    if (ret == STPMIC_RET_OK) {
+        ret = stpmic_write(STPMIC_REG_MAIN_CR, STPMIC_MAINCR_RREQ_EN | STPMIC_MAINCR_SWOFF);
+    }
+
+    if (ret == STPMIC_RET_OK) {
+        ret = stpmic_reconcile_setup(&opts);
+    }
+
+    return ret;
+}
+
+/* the cleared command is not a drift, nothing should be written. */
+static stpmic_ret_t __stpmic_bench_reconcile_cmd(stpmic_sim_t* sim) {
+    stpmic_ret_t ret = stpmic_reconcile();
+
+    if (ret == STPMIC_RET_OK && (sim->swoffs || STPMIC_CTX_DEFAULT->rec.drifts)) {
+        return STPMIC_RET_UNKNOWN;
+    }
+
+    return ret;
+}
+#endif
+
+static stpmic_ret_t __stpmic_bench_restart_check(stpmic_sim_t* sim) {
+    (void) sim;
+    return stpmic_restart_check(NULL);
+}
+
+/* BUCK1_MAIN_CR is written, then the device restarts. */
+static stpmic_ret_t __stpmic_bench_restart_prepare(stpmic_sim_t* sim) {
+    stpmic_ret_t ret = __stpmic_bench_init(sim);
+
+    if (ret == STPMIC_RET_OK) {
+        ret = stpmic_restart_check(NULL);
+    }
+
+    if (ret == STPMIC_RET_OK) {
+        ret = stpmic_write(STPMIC_REG_BUCK1_MAIN_CR, 0x55);
+    }
+
+    stpmic_sim_restart(sim, STPMIC_BIT_MASK(2));
+    return ret;
+}
+
+static stpmic_ret_t __stpmic_bench_restart_apply(stpmic_sim_t* sim) {
+    uint8_t restarted = 0;
+    stpmic_ret_t ret = stpmic_restart_check(&restarted);
+
+    if (ret == STPMIC_RET_OK && (!restarted || sim->regs[STPMIC_REG_BUCK1_MAIN_CR] != 0x55)) {
+        return STPMIC_RET_UNKNOWN;
+    }
+
+    return ret;
+}
+
+/* switch-off is requested, then the device restarts by it. */
+static stpmic_ret_t __stpmic_bench_restart_swoff(stpmic_sim_t* sim) {
+    stpmic_ret_t ret = __stpmic_bench_init(sim);
+
+    if (ret == STPMIC_RET_OK) {
+        ret = stpmic_restart_check(NULL);
+    }
+
+    if (ret == STPMIC_RET_OK) {
+        ret = stpmic_request_swoff();
+    }
+
+    stpmic_sim_restart(sim, STPMIC_RESTARTSR_SWOUT);
+    return ret;
+}
+
+/* the request is a command, it must not be re-applied. */
+static stpmic_ret_t __stpmic_bench_restart_once(stpmic_sim_t* sim) {
+    uint8_t restarted = 0;
+    stpmic_ret_t ret = stpmic_restart_check(&restarted);
+
+    if (ret == STPMIC_RET_OK && (!restarted || sim->swoffs)) {
+        return STPMIC_RET_UNKNOWN;
+    }
+
+    return ret;
+}
+
+/* PWRCTRL switches to ALTERNATE and LDO4 to VBUSOTG, not a restart. */
+static stpmic_ret_t __stpmic_bench_restart_mode(stpmic_sim_t* sim) {
+    stpmic_ret_t ret = __stpmic_bench_init(sim);
+
+    if (ret == STPMIC_RET_OK) {
+        ret = stpmic_restart_check(NULL);
+    }
+
+    sim->regs[STPMIC_REG_RESTART_SR] |= 
+        STPMIC_RESTARTSR_OP_MODE_ALTERNATIVE | STPMIC_RESTARTSR_LDO4_SRC_VBUSOTG;
+
+    return ret;
+}
+
+static stpmic_ret_t __stpmic_bench_restart_none(stpmic_sim_t* sim) {
+    (void) sim;
+    uint8_t restarted = 0;
+    stpmic_ret_t ret = stpmic_restart_check(&restarted);
+
+    if (ret == STPMIC_RET_OK && (restarted || STPMIC_CTX_DEFAULT->restarts)) {
+        return STPMIC_RET_UNKNOWN;
+    }
+
+    return ret;
+}
+
+static stpmic_ret_t __stpmic_bench_version(stpmic_sim_t* sim) {
+    (void) sim;
+    stpmic_version_t ver;
+    return stpmic_version(&ver);
+}
+
+static stpmic_ret_t __stpmic_bench_buck_setup(stpmic_sim_t* sim) {
+    (void) sim;
+    stpmic_buck_t opts = {
+        .pd = STPMIC_BUCKSPD_AUTO_HIGH,
+        .mode = STPMIC_PREGMODE_HIGH,
+        .volts = STPMIC_BUCK1VOLTS_1V2,
+        .enable = 1
+    };
+
+    return stpmic_buck_setup(1, &opts);
+}
+
+static stpmic_ret_t __stpmic_bench_txn_commit(stpmic_sim_t* sim) {
+    (void) sim;
+    stpmic_buck_t opts = {
+        .pd = STPMIC_BUCKSPD_AUTO_HIGH,
+        .mode = STPMIC_PREGMODE_HIGH,
+        .volts = STPMIC_BUCK1VOLTS_1V2,
+        .enable = 1
+    };
+
+    stpmic_ret_t ret = stpmic_txn_begin();
+    if (ret != STPMIC_RET_OK) {
+        return ret;
+    }
+
+    // --> two rails: a burst for both `BUCKx_MAIN_CR`, `BUCKS_PD_CR` once.
+    if ((ret = stpmic_buck_setup(1, &opts)) != STPMIC_RET_OK ||
+        (ret = stpmic_buck_setup(2, &opts)) != STPMIC_RET_OK)
+    {
+        stpmic_txn_abort();
+        return ret;
+    }
+
+    return stpmic_txn_commit();
+}
+
+static stpmic_ret_t __stpmic_bench_buck_enable(stpmic_sim_t* sim) {
+    (void) sim;
+    return stpmic_buck_enable(1);
+}
+
+static stpmic_ret_t __stpmic_bench_ldo_setup(stpmic_sim_t* sim) {
+    (void) sim;
+    stpmic_ldo_t opts = {
+        .pd = STPMIC_LDOSPD_ACTIVE,
+        .enable = 1,
+        .volts = STPMIC_LDO123VOLTS_3V3,
+    };
+
+    return stpmic_ldo_setup(1, &opts);
+}
+
+static stpmic_ret_t __stpmic_bench_ldo_enable(stpmic_sim_t* sim) {
+    (void) sim;
+    return stpmic_ldo_enable(1);
+}
+
+static stpmic_ret_t __stpmic_bench_refddr_enable(stpmic_sim_t* sim) {
+    (void) sim;
+    return stpmic_refddr_enable();
+}
+
+static stpmic_ret_t __stpmic_bench_set_mrst(stpmic_sim_t* sim) {
+    (void) sim;
+    return stpmic_set_mrst(0x3f);
+}
+
+static stpmic_ret_t __stpmic_bench_watchdog_init(stpmic_sim_t* sim) {
+    (void) sim;
+    return stpmic_watchdog_init(10);
+}
+
+static stpmic_ret_t __stpmic_bench_pwrctrl_init(stpmic_sim_t* sim) {
+    (void) sim;
+    stpmic_pwrctrl_t opts = {
+        .pol = STPMIC_POL_ACTIVE_HIGH,
+        .pull = STPMIC_PULL_DOWN,
+        .en = 1
+    };
+
+    return stpmic_pwrctrl_init(&opts);
+}
+
+/* raise interrupts, then initialize the driver. */
+static stpmic_ret_t __stpmic_bench_raise(stpmic_sim_t* sim) {
+    stpmic_sim_raise(sim, STPMIC_INTFLAG_LDO1_OCP | STPMIC_INTFLAG_BUCK2_OCP);
+    return __stpmic_bench_init(sim);
+}
+
+static stpmic_ret_t __stpmic_bench_interrupt_pending(stpmic_sim_t* sim) {
+    (void) sim;
+    uint32_t pending;
+    return stpmic_interrupt_pending(&pending);
+}
+
+static stpmic_ret_t __stpmic_bench_interrupt_clear(stpmic_sim_t* sim) {
+    (void) sim;
+    return stpmic_interrupt_clear(STPMIC_INTFLAG_LDO1_OCP | STPMIC_INTFLAG_BUCK2_OCP);
+}
+
+static uint8_t __stpmic_bench_ocp(stpmic_ctx_t* ctx, uint32_t flag, void* arg) {
+    (void) ctx;
+    (void) flag;
+    (void) arg;
+    return 1;
+}
+
+/* handlers of flags that are not raised cost nothing. */
+static const stpmic_irq_handler_t STPMIC_BENCH_HANDLERS[STPMIC_INTFLAG_COUNT] = {
+    [0] = __stpmic_bench_ocp,
+    [9] = __stpmic_bench_ocp,
+    [16] = __stpmic_bench_ocp,
+    [27] = __stpmic_bench_ocp
+};
+
+static stpmic_ret_t __stpmic_bench_interrupt_dispatch(stpmic_sim_t* sim) {
+    uint32_t acked = 0;
+    stpmic_ret_t ret = stpmic_interrupt_dispatch(STPMIC_BENCH_HANDLERS, NULL, &acked);
+
+    if (ret == STPMIC_RET_OK && (acked != (STPMIC_INTFLAG_LDO1_OCP | STPMIC_INTFLAG_BUCK2_OCP) || stpmic_sim_irq(sim))) {
+        return STPMIC_RET_UNKNOWN;
+    }
+
+    return ret;
+}
+
+#if STPMIC_IRQ_RING
+/* raise interrupts and notify them three times. */
+static stpmic_ret_t __stpmic_bench_irq_notify(stpmic_sim_t* sim) {
+    stpmic_ret_t ret = __stpmic_bench_raise(sim);
+
+    for (uint8_t i = 0; i < 3 && ret == STPMIC_RET_OK; ++i) {
+        ret = stpmic_irq_notify(i);
+    }
+
+    return ret;
+}
+
+static stpmic_ret_t __stpmic_bench_irq_service(stpmic_sim_t* sim) {
+    (void) sim;
+    uint32_t acked = 0;
+    stpmic_ret_t ret = stpmic_irq_service(STPMIC_BENCH_HANDLERS, NULL, &acked);
+
+    if (ret == STPMIC_RET_OK && acked != (STPMIC_INTFLAG_LDO1_OCP | STPMIC_INTFLAG_BUCK2_OCP)) {
+        return STPMIC_RET_UNKNOWN;
+    }
+
+    // --> nothing is queued anymore, no bus access.
+    if (ret == STPMIC_RET_OK) {
+        ret = stpmic_irq_service(STPMIC_BENCH_HANDLERS, NULL, NULL);
+    }
+
+    return ret;
+}
+#endif
+
+#if STPMIC_EVLOG_SIZE
+/* BUCK1_OCP handler is limited to 2 calls a second. */
+static stpmic_ret_t __stpmic_bench_evlog_setup(stpmic_sim_t* sim) {
+    stpmic_evlog_t opts = { .window = 1000, .limit = { [8] = 2 } };
+    stpmic_ret_t ret = __stpmic_bench_init(sim);
+
+    if (ret == STPMIC_RET_OK) {
+        ret = stpmic_evlog_setup(&opts);
+    }
+
+    return ret;
+}
+
+/* five overcurrents in a row, coalesced into an entry. */
+static stpmic_ret_t __stpmic_bench_evlog_storm(stpmic_sim_t* sim) {
+    uint32_t acks = 0;
+    stpmic_irq_handler_t handlers[STPMIC_INTFLAG_COUNT] = { [8] = __stpmic_bench_ocp };
+    stpmic_event_t ev;
+    uint8_t count = 0;
+
+    for (uint8_t i = 0; i < 5; ++i) {
+        uint32_t acked = 0;
+        stpmic_ret_t ret;
+
+        stpmic_sim_raise(sim, STPMIC_INTFLAG_BUCK1_OCP);
+        if ((ret = stpmic_interrupt_dispatch(handlers, NULL, &acked)) != STPMIC_RET_OK) {
+            return ret;
+        }
+
+        acks += acked ? 1 : 0;
+    }
+
+    stpmic_evlog_read(&ev, 1, &count);
+    if (acks != 5 || STPMIC_CTX_DEFAULT->evlog.suppressed != 3 || 
+        count != 1 || ev.bit != 8 || ev.count != 5)
+    {
+        return STPMIC_RET_UNKNOWN;
+    }
+
+    return STPMIC_RET_OK;
+}
+#endif
+
+#if STPMIC_USE_OCP_POLICY
+/* LDO1 is enabled, invalidated and disabled by its overcurrent. */
+static stpmic_ret_t __stpmic_bench_ocp_setup(stpmic_sim_t* sim) {
+    stpmic_ocp_policy_t policy = { .rails = { [STPMIC_OCP_LDO1] = { .action = STPMIC_OCP_DISABLE } } };
+    stpmic_ret_t ret = __stpmic_bench_init(sim);
+
+    if (ret == STPMIC_RET_OK) {
+        ret = stpmic_ldo_enable(1);
+    }
+
+    if (ret == STPMIC_RET_OK) {
+        ret = stpmic_ocp_setup(&policy);
+    }
+
+    // --> the response must not read the control register again.
+    if (ret == STPMIC_RET_OK) {
+        ret = stpmic_clear_cache(STPMIC_REG_LDOx_MAIN_CR);
+    }
+
+    stpmic_sim_raise(sim, STPMIC_INTFLAG_LDO1_OCP);
+    return ret;
+}
+
+/* pending read, protective write and clear, no reads between. */
+static stpmic_ret_t __stpmic_bench_ocp_respond(stpmic_sim_t* sim) {
+    static const stpmic_irq_handler_t handlers[STPMIC_INTFLAG_COUNT] = { NULL, };
+    stpmic_ret_t ret = stpmic_interrupt_dispatch(handlers, NULL, NULL);
+
+    if (ret == STPMIC_RET_OK && (sim->regs[STPMIC_REG_LDOx_MAIN_CR] & STPMIC_BIT_MASK(0))) {
+        return STPMIC_RET_UNKNOWN;
+    }
+
+    return ret;
+}
+#endif
+
+static stpmic_ret_t __stpmic_bench_interrupt_read_mask(stpmic_sim_t* sim) {
+    (void) sim;
+    uint32_t mask;
+    return stpmic_interrupt_read_mask(&mask);
+}
+
+static stpmic_ret_t __stpmic_bench_interrupt_mask_set(stpmic_sim_t* sim) {
+    (void) sim;
+    return stpmic_interrupt_mask_set(STPMIC_INTFLAG_LDO1_OCP | STPMIC_INTFLAG_BUCK2_OCP);
+}
+
+static stpmic_ret_t __stpmic_bench_nvm_read(stpmic_sim_t* sim) {
+    (void) sim;
+    stpmic_nvmregs_t regs;
+    return stpmic_nvm_read(&regs);
+}
+
+static stpmic_ret_t __stpmic_bench_nvm_write(stpmic_sim_t* sim) {
+    (void) sim;
+    stpmic_nvmregs_t regs = { 0, };
+
+    // --> all shadow registers except I2C_ADDR_SHR.
+    regs.dirty = (1u << (STPMIC_REG_NVM_COUNT - 1)) - 1;
+    return stpmic_nvm_write(&regs);
+}
+
+/* NVM busy time is excluded: polls would depend on the bus clock. */
+static stpmic_ret_t __stpmic_bench_nvm_prepare(stpmic_sim_t* sim) {
+    sim->nvm_busy_ns = 0;
+    return __stpmic_bench_init(sim);
+}
+
+static stpmic_ret_t __stpmic_bench_nvm_program(stpmic_sim_t* sim) {
+    (void) sim;
+    return stpmic_nvm_program();
+}
+
+/* reserve writes to two runs of adjacent registers. */
+static stpmic_ret_t __stpmic_bench_batch_prepare(stpmic_sim_t* sim) {
+    stpmic_ret_t ret = __stpmic_bench_init(sim);
+
+    for (uint8_t i = 0; i < 4 && ret == STPMIC_RET_OK; ++i) {
+        ret = stpmic_batch_write((stpmic_regid_t)(STPMIC_REG_BUCK1_MAIN_CR + i), 0x81);
+    }
+
+    for (uint8_t i = 0; i < 2 && ret == STPMIC_RET_OK; ++i) {
+        ret = stpmic_batch_write((stpmic_regid_t)(STPMIC_REG_LDO5_MAIN_CR + i), 0x41);
+    }
+
+    return ret;
+}
+
+static stpmic_ret_t __stpmic_bench_batch_flush(stpmic_sim_t* sim) {
+    (void) sim;
+    return stpmic_batch_flush();
+}
+
+/**
+ * benchmark cases and budgets.
+ * budgets are { transfers, bytes } and should only be raised on purpose.
+ */
+static const stpmic_bench_case_t STPMIC_BENCH_CASES[] = {
+    { "stpmic_init",                NULL,                           __stpmic_bench_run_init,            6, 66 },
+#if STPMIC_USE_RETAIN
+    { "stpmic_init (warm)",         __stpmic_bench_warm_prepare,    __stpmic_bench_warm_init,           1, 14 },
+#endif
+    { "stpmic_reload_cache",        __stpmic_bench_init,            __stpmic_bench_reload_cache,        5, 62 },
+    { "stpmic_read",                __stpmic_bench_init,            __stpmic_bench_read,                0, 0 },
+#if STPMIC_READ_AHEAD >= 3
+    { "stpmic_read (miss)",         __stpmic_bench_miss_prepare,    __stpmic_bench_read_miss,           1, 7 },
+#endif
+    { "stpmic_read_direct",         __stpmic_bench_init,            __stpmic_bench_read_direct,         1, 4 },
+    { "stpmic_write",               __stpmic_bench_init,            __stpmic_bench_write,               1, 3 },
+    { "stpmic_update_bits",         __stpmic_bench_init,            __stpmic_bench_update_bits,         1, 3 },
+    { "stpmic_update_bits (same)",  __stpmic_bench_init,            __stpmic_bench_update_bits_same,    0, 0 },
+#if STPMIC_USE_RECONCILE
+    { "stpmic_reconcile (drift)",   __stpmic_bench_reconcile_prepare, __stpmic_bench_reconcile,         2, 7 },
+    { "stpmic_reconcile (command)", __stpmic_bench_reconcile_cmd_prepare, __stpmic_bench_reconcile_cmd, 1, 4 },
+#endif
+    { "stpmic_restart_check",       __stpmic_bench_init,            __stpmic_bench_restart_check,       1, 8 },
+    { "stpmic_restart_check (restarted)", __stpmic_bench_restart_prepare, __stpmic_bench_restart_apply, 2, 11 },
+    { "stpmic_restart_check (op mode)", __stpmic_bench_restart_mode, __stpmic_bench_restart_none,   1, 8 },
+    { "stpmic_restart_check (swoff)", __stpmic_bench_restart_swoff, __stpmic_bench_restart_once,     1, 8 },
+    { "stpmic_version",             __stpmic_bench_init,            __stpmic_bench_version,             0, 0 },
+    { "stpmic_buck_setup",          __stpmic_bench_init,            __stpmic_bench_buck_setup,          2, 6 },
+    { "stpmic_txn_commit",          __stpmic_bench_init,            __stpmic_bench_txn_commit,          2, 7 },
+    { "stpmic_buck_enable",         __stpmic_bench_init,            __stpmic_bench_buck_enable,         1, 3 },
+    { "stpmic_ldo_setup",           __stpmic_bench_init,            __stpmic_bench_ldo_setup,           1, 3 },
+    { "stpmic_ldo_enable",          __stpmic_bench_init,            __stpmic_bench_ldo_enable,          1, 3 },
+    { "stpmic_refddr_enable",       __stpmic_bench_init,            __stpmic_bench_refddr_enable,       1, 3 },
+    { "stpmic_set_mrst",            __stpmic_bench_init,            __stpmic_bench_set_mrst,            1, 3 },
+    { "stpmic_watchdog_init",       __stpmic_bench_init,            __stpmic_bench_watchdog_init,       2, 6 },
+    { "stpmic_pwrctrl_init",        __stpmic_bench_init,            __stpmic_bench_pwrctrl_init,        2, 6 },
+    { "stpmic_interrupt_pending",   __stpmic_bench_raise,           __stpmic_bench_interrupt_pending,   1, 7 },
+    { "stpmic_interrupt_clear",     __stpmic_bench_raise,           __stpmic_bench_interrupt_clear,     1, 4 },
+    { "stpmic_interrupt_dispatch",  __stpmic_bench_raise,           __stpmic_bench_interrupt_dispatch,  2, 11 },
+#if STPMIC_USE_OCP_POLICY
+    { "stpmic_interrupt_dispatch (ocp)", __stpmic_bench_ocp_setup,  __stpmic_bench_ocp_respond,         3, 13 },
+#endif
+#if STPMIC_EVLOG_SIZE
+    { "stpmic_interrupt_dispatch (storm)", __stpmic_bench_evlog_setup, __stpmic_bench_evlog_storm,  10, 50 },
+#endif
+#if STPMIC_IRQ_RING
+    { "stpmic_irq_service",         __stpmic_bench_irq_notify,      __stpmic_bench_irq_service,         2, 11 },
+#endif
+    { "stpmic_interrupt_read_mask", __stpmic_bench_init,            __stpmic_bench_interrupt_read_mask, 0, 0 },
+    { "stpmic_interrupt_mask_set",  __stpmic_bench_init,            __stpmic_bench_interrupt_mask_set,  2, 6 },
+    { "stpmic_nvm_read",            __stpmic_bench_init,            __stpmic_bench_nvm_read,            0, 0 },
+    { "stpmic_nvm_write",           __stpmic_bench_init,            __stpmic_bench_nvm_write,           7, 21 },
+    { "stpmic_nvm_program",         __stpmic_bench_nvm_prepare,     __stpmic_bench_nvm_program,         3, 11 },
+    { "stpmic_batch_flush",         __stpmic_bench_batch_prepare,   __stpmic_bench_batch_flush,         2, 10 },
+    { NULL, NULL, NULL, 0, 0 }
+};
+
+/* run a benchmark case. */
+uint8_t stpmic_bench_case(const stpmic_bench_case_t* bench, stpmic_bench_result_t* out) {
+    stpmic_sim_t sim;
+
+    out->bench = bench;
+    out->ret = STPMIC_RET_OK;
+    out->xfers = 0;
+    out->bytes = 0;
+
+    for (uint8_t i = 0; i < STPMIC_BENCH_CLOCKS; ++i) {
+        stpmic_ret_t ret = STPMIC_RET_OK;
+
+        stpmic_deinit();
+        stpmic_sim_init(&sim, -1);
+        stpmic_sim_set_clock(&sim, STPMIC_BENCH_HZ[i]);
+
+        if (bench->prepare) {
+            ret = bench->prepare(&sim);
+        }
+
+        stpmic_sim_reset_stats(&sim);
+        if (ret == STPMIC_RET_OK) {
+            ret = bench->run(&sim);
+        }
+
+        if (out->ret == STPMIC_RET_OK) {
+            out->ret = ret;
+        }
+
+        // --> counts don't depend on the clock, but take the worst.
+        if (out->xfers < sim.xfers) {
+            out->xfers = sim.xfers;
+        }
+
+        if (out->bytes < sim.bytes) {
+            out->bytes = sim.bytes;
+        }
+
+        out->ns[i] = sim.now_ns;
+    }
+
+    stpmic_deinit();
+    return out->ret != STPMIC_RET_OK ||
+        out->xfers > bench->max_xfers ||
+        out->bytes > bench->max_bytes;
+}
+
+/* run all benchmark cases. */
+uint32_t stpmic_bench_run(FILE* out) {
+    const stpmic_bench_case_t* bench = STPMIC_BENCH_CASES;
+    stpmic_bench_result_t result;
+    uint32_t fails = 0;
+
+    if (out) {
+        fprintf(out, "%-28s %6s %6s %10s %10s %10s  %s\n",
+            "api", "xfers", "bytes", "100kHz(us)", "400kHz(us)", "1MHz(us)", "budget");
+    }
+
+    for (; bench->name; ++bench) {
+        uint8_t fail = stpmic_bench_case(bench, &result);
+
+        fails += fail;
+        if (!out) {
+            continue;
+        }
+
+        fprintf(out, "%-28s %6u %6u %10.1f %10.1f %10.1f  %u/%u %s",
+            bench->name, result.xfers, result.bytes,
+            result.ns[0] / 1000.0, result.ns[1] / 1000.0, result.ns[2] / 1000.0,
+            bench->max_xfers, bench->max_bytes, fail ? "FAIL" : "ok");
+
+        if (result.ret != STPMIC_RET_OK) {
+            fprintf(out, " (ret: %d)", (int) result.ret);
+        }
+
+        fprintf(out, "\n");
+    }
+
+    if (out) {
+        fprintf(out, "%u case(s) failed.\n", fails);
+    }
+
+    return fails;
+}
+#endif
@@ -0,0 +1,83 @@
+#ifndef __STPMIC_BENCH_H__
+#define __STPMIC_BENCH_H__
+
+#include <stdio.h>
+#include "stpmic_sim.h"
+
+/**
+ * STPMIC driver.
+ * --
+ * author: jay94ks@gmail.com
+ * repository: https://github.com/jay94ks/stpmic
+ * --
+ * Copyright(C) 2025, jay94ks.
+ * License: MIT.
+ *
+ * --
+ * bus cost benchmark of the driver APIs, runs on the simulated STPMIC1.
+ * each API is run at 100 kHz, 400 kHz and 1 MHz bus clock and measured by
+ * I2C transfers, bytes on the wire and modelled time.
+ * transfers and bytes are checked against budgets in `stpmic_bench.c`,
+ * lower budgets there when an improvement is made.
+ *
+ *  int main() {
+ *      return stpmic_bench_run(stdout) ? 1 : 0;
+ *  }
+ */
+
+#if STPMIC_USE_CHAN
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* count of bus clocks that the benchmark runs at. */
+#define STPMIC_BENCH_CLOCKS     3
+
+/* a benchmark case. */
+typedef struct {
+    const char*     name;
+
+    /* prepare the driver and device, not measured, nullable. */
+    stpmic_ret_t    (*prepare)(stpmic_sim_t* sim);
+
+    /* run the API to measure. */
+    stpmic_ret_t    (*run)(stpmic_sim_t* sim);
+
+    /* budgets. */
+    uint16_t        max_xfers;
+    uint16_t        max_bytes;
+} stpmic_bench_case_t;
+
+/* result of a benchmark case. */
+typedef struct {
+    const stpmic_bench_case_t* bench;
+    stpmic_ret_t    ret;
+    uint32_t        xfers;
+    uint32_t        bytes;
+    uint64_t        ns[STPMIC_BENCH_CLOCKS];
+} stpmic_bench_result_t;
+
+/* bus clocks that the benchmark runs at. */
+extern const uint32_t STPMIC_BENCH_HZ[STPMIC_BENCH_CLOCKS];
+
+/**
+ * run a benchmark case.
+ * this de-initializes the driver and initializes it again on a new simulated device.
+ * @param bench case to run.
+ * @param out result.
+ * @return 1 if the case failed or exceeded its budgets, 0 otherwise.
+ */
+uint8_t stpmic_bench_case(const stpmic_bench_case_t* bench, stpmic_bench_result_t* out);
+
+/**
+ * run all benchmark cases.
+ * @param out stream to print the report, nullable.
+ * @return count of cases that failed or exceeded their budgets.
+ */
+uint32_t stpmic_bench_run(FILE* out);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+#endif
@@ -0,0 +1,291 @@
+#include "stpmic_sim.h"
+#include <string.h>
+
+#if STPMIC_USE_CHAN
+/* default address and version of the simulated STPMIC1. */
+#define STPMIC_SIM_DEF_ADDR     0x33u
+#define STPMIC_SIM_VERSION      0x21u
+
+/* NVM operation time, tens of milliseconds on the real device. */
+#define STPMIC_SIM_NVM_BUSY_NS  (20u * 1000u * 1000u)
+
+/* count of shadow registers. */
+#define STPMIC_SIM_NVM_COUNT    (STPMIC_REG_MAX - STPMIC_REG_NVM_MAIN_CTRL_SHR)
+
+/* test whether the register is in `[first, first + 4)` or not. */
+#define STPMIC_SIM_IN_R4(reg, first)    ((reg) >= (first) && (reg) < (first) + 4)
+
+/* spend the cost of a transfer. */
+static void __stpmic_sim_spend(stpmic_sim_t* sim, uint32_t conds, uint32_t bytes) {
+    uint32_t ns = sim->xfer_ns + conds * sim->cond_ns + bytes * sim->byte_ns;
+
+    sim->xfers++;
+    sim->bytes += bytes;
+    sim->now_ns += ns;
+
+    if (sim->delay && ns) {
+        sim->delay(sim, ns);
+    }
+}
+
+/* test whether the NVM controller is busy or not. */
+static uint8_t __stpmic_sim_nvm_busy(stpmic_sim_t* sim) {
+    // --> zero latency: nothing advances the time, complete at the next access.
+    if (sim->nvm_done_ns > sim->now_ns && (sim->byte_ns || sim->xfer_ns || sim->cond_ns)) {
+        return 1;
+    }
+
+    sim->nvm_done_ns = 0;
+    return 0;
+}
+
+/* update `INT_PENDING_Rx` and `INT_DBG_LATCH_Rx` registers. */
+static void __stpmic_sim_latch(stpmic_sim_t* sim, uint32_t bitmap) {
+    for (uint8_t i = 0; i < 4; ++i) {
+        uint8_t bits = (uint8_t)(bitmap >> (i << 3));
+
+        sim->regs[STPMIC_REG_INT_DBG_LATCH_R1 + i] |= bits;
+        sim->regs[STPMIC_REG_INT_PENDING_R1 + i] |=
+            bits & ~sim->regs[STPMIC_REG_INT_MASK_R1 + i];
+    }
+}
+
+/* read a register. */
+static stpmic_reg_t __stpmic_sim_read(stpmic_sim_t* sim, uint8_t reg) {
+    if (reg == STPMIC_REG_NVM_SR) {
+        return __stpmic_sim_nvm_busy(sim) ? STPMIC_BIT_MASK(0) : 0;
+    }
+
+    return sim->regs[reg];
+}
+
+/* write a register. */
+static void __stpmic_sim_write(stpmic_sim_t* sim, uint8_t reg, stpmic_reg_t val) {
+    // --> W1C: clear pending bits.
+    if (STPMIC_SIM_IN_R4(reg, STPMIC_REG_INT_CLEAR_R1)) {
+        sim->regs[STPMIC_REG_INT_PENDING_R1 + (reg - STPMIC_REG_INT_CLEAR_R1)] &= ~val;
+        return;
+    }
+
+    if (STPMIC_SIM_IN_R4(reg, STPMIC_REG_INT_MASK_SET_R1)) {
+        sim->regs[STPMIC_REG_INT_MASK_R1 + (reg - STPMIC_REG_INT_MASK_SET_R1)] |= val;
+        return;
+    }
+
+    if (STPMIC_SIM_IN_R4(reg, STPMIC_REG_INT_MASK_CLEAR_R1)) {
+        sim->regs[STPMIC_REG_INT_MASK_R1 + (reg - STPMIC_REG_INT_MASK_CLEAR_R1)] &= ~val;
+        return;
+    }
+
+    if (reg == STPMIC_REG_NVM_CR) {
+        uint8_t opcode = val & 3u;
+
+        // --> 00, 11: nop, commands are ignored while busy.
+        if (opcode == 0 || opcode == 3 || __stpmic_sim_nvm_busy(sim)) {
+            return;
+        }
+
+        if (opcode == STPMIC_NVMCMD_PROGRAM) {
+            memcpy(sim->nvm, &sim->regs[STPMIC_REG_NVM_MAIN_CTRL_SHR], STPMIC_SIM_NVM_COUNT);
+        }
+
+        else {
+            memcpy(&sim->regs[STPMIC_REG_NVM_MAIN_CTRL_SHR], sim->nvm, STPMIC_SIM_NVM_COUNT);
+        }
+
+        sim->nvm_done_ns = sim->now_ns + sim->nvm_busy_ns;
+        return;
+    }
+
+    // --> SWOFF clears itself, the device stays on in the simulation.
+    if (reg == STPMIC_REG_MAIN_CR && (val & STPMIC_MAINCR_SWOFF)) {
+        val &= (stpmic_reg_t) ~STPMIC_MAINCR_SWOFF;
+        sim->swoffs++;
+    }
+
+    // --> control and shadow registers.
+    if ((reg >= STPMIC_REG_MAIN_CR && reg <= STPMIC_REG_WDG_TMR_CR) ||
+        (reg >= STPMIC_REG_BUCKx_MAIN_CR && reg < STPMIC_REG_CACHE_MAX) ||
+        (reg >= STPMIC_REG_NVM_MAIN_CTRL_SHR))
+    {
+        sim->regs[reg] = val;
+        return;
+    }
+
+    sim->ignored++;
+}
+
+/* I2C channel: read bytes from the address pointer. */
+static uint8_t __stpmic_sim_read_i2c(
+    stpmic_i2c_t* chan, uint8_t addr,
+    uint8_t* buf, uint32_t len, uint32_t timeout)
+{
+    stpmic_sim_t* sim = (stpmic_sim_t*) chan;
+    (void) timeout; // --> the bus time is modeled, never waits.
+
+    // --> START, address, values, STOP.
+    __stpmic_sim_spend(sim, 2, 1 + len);
+
+    if ((addr >> 1) != sim->addr) {
+        sim->nacks++;
+        return 0;
+    }
+
+    for (uint32_t i = 0; i < len; ++i) {
+        buf[i] = __stpmic_sim_read(sim, sim->ptr++);
+    }
+
+    return (uint8_t) len;
+}
+
+/* I2C channel: set the address pointer, then write bytes. */
+static uint8_t __stpmic_sim_write_i2c(
+    stpmic_i2c_t* chan, uint8_t addr,
+    uint8_t* buf, uint32_t len, uint32_t timeout)
+{
+    stpmic_sim_t* sim = (stpmic_sim_t*) chan;
+    (void) timeout; // --> the bus time is modeled, never waits.
+
+    // --> START, address, register address, values, STOP.
+    __stpmic_sim_spend(sim, 2, 1 + len);
+
+    if ((addr >> 1) != sim->addr || !len) {
+        sim->nacks++;
+        return 0;
+    }
+
+    sim->ptr = buf[0];
+    for (uint32_t i = 1; i < len; ++i) {
+        __stpmic_sim_write(sim, sim->ptr++, buf[i]);
+    }
+
+    return (uint8_t) len;
+}
+
+/* I2C channel: combined write/repeated-start/read transfer. */
+static uint8_t __stpmic_sim_read_reg_i2c(
+    stpmic_i2c_t* chan, uint8_t addr, uint8_t reg,
+    uint8_t* buf, uint32_t len, uint32_t timeout)
+{
+    stpmic_sim_t* sim = (stpmic_sim_t*) chan;
+    (void) timeout; // --> the bus time is modeled, never waits.
+
+    // --> START, address, register address, repeated-START, address, values, STOP.
+    __stpmic_sim_spend(sim, 3, 3 + len);
+
+    if ((addr >> 1) != sim->addr) {
+        sim->nacks++;
+        return 0;
+    }
+
+    sim->ptr = reg;
+    for (uint32_t i = 0; i < len; ++i) {
+        buf[i] = __stpmic_sim_read(sim, sim->ptr++);
+    }
+
+    return (uint8_t) len;
+}
+
+/* I2C channel: modelled time in milliseconds. */
+static uint32_t __stpmic_sim_get_tick(stpmic_i2c_t* chan) {
+    stpmic_sim_t* sim = (stpmic_sim_t*) chan;
+    return (uint32_t)(sim->now_ns / 1000000u);
+}
+
+/* initialize the simulated device and power it on. */
+void stpmic_sim_init(stpmic_sim_t* sim, int16_t addr) {
+    memset(sim, 0, sizeof(*sim));
+
+    sim->chan.read_i2c = __stpmic_sim_read_i2c;
+    sim->chan.write_i2c = __stpmic_sim_write_i2c;
+    sim->chan.read_reg_i2c = __stpmic_sim_read_reg_i2c;
+    sim->chan.xfer_async = NULL;
+    sim->chan.get_tick = __stpmic_sim_get_tick;
+
+    sim->addr = addr < 0 ? STPMIC_SIM_DEF_ADDR : (uint8_t)(addr & 0x7f);
+    sim->nvm_busy_ns = STPMIC_SIM_NVM_BUSY_NS;
+    sim->nvm[STPMIC_REG_I2C_ADDR_SHR - STPMIC_REG_NVM_MAIN_CTRL_SHR] = sim->addr;
+
+    stpmic_sim_power_on(sim, 0);
+}
+
+/* set latency from I2C bus clock. */
+void stpmic_sim_set_clock(stpmic_sim_t* sim, uint32_t hz) {
+    uint32_t clk_ns = hz ? (1000000000u + hz - 1) / hz : 0;
+    stpmic_sim_set_latency(sim, clk_ns * 9, clk_ns, sim->xfer_ns);
+}
+
+/* set latency per byte, per condition and per transfer. */
+void stpmic_sim_set_latency(stpmic_sim_t* sim, uint32_t byte_ns, uint32_t cond_ns, uint32_t xfer_ns) {
+    sim->byte_ns = byte_ns;
+    sim->cond_ns = cond_ns;
+    sim->xfer_ns = xfer_ns;
+}
+
+/* advance the modelled time without bus activity. */
+void stpmic_sim_advance(stpmic_sim_t* sim, uint32_t ns) {
+    sim->now_ns += ns;
+}
+
+/* reset statistics and the modelled time. */
+void stpmic_sim_reset_stats(stpmic_sim_t* sim) {
+    // --> keep pending NVM operation relative to the new origin.
+    if (sim->nvm_done_ns > sim->now_ns) {
+        sim->nvm_done_ns -= sim->now_ns;
+    }
+
+    else {
+        sim->nvm_done_ns = 0;
+    }
+
+    sim->now_ns = 0;
+    sim->xfers = 0;
+    sim->bytes = 0;
+    sim->nacks = 0;
+    sim->ignored = 0;
+    sim->swoffs = 0;
+}
+
+/* power the device on. */
+void stpmic_sim_power_on(stpmic_sim_t* sim, stpmic_reg_t turn_on_sr) {
+    memset(sim->regs, 0, sizeof(sim->regs));
+    memcpy(&sim->regs[STPMIC_REG_NVM_MAIN_CTRL_SHR], sim->nvm, STPMIC_SIM_NVM_COUNT);
+
+    sim->regs[STPMIC_REG_TURN_ON_SR] = turn_on_sr;
+    sim->regs[STPMIC_REG_VERSION_SR] = STPMIC_SIM_VERSION;
+    sim->ptr = 0;
+    sim->nvm_done_ns = 0;
+}
+
+/* restart the device like power-on, but keeps `TURN_OFF_SR`. */
+void stpmic_sim_restart(stpmic_sim_t* sim, stpmic_reg_t restart_sr) {
+    stpmic_reg_t turn_off_sr = sim->regs[STPMIC_REG_TURN_OFF_SR];
+
+    stpmic_sim_power_on(sim, 0);
+    sim->regs[STPMIC_REG_TURN_OFF_SR] = turn_off_sr;
+    sim->regs[STPMIC_REG_RESTART_SR] = restart_sr;
+}
+
+/* raise interrupt events. */
+void stpmic_sim_raise(stpmic_sim_t* sim, uint32_t bitmap) {
+    __stpmic_sim_latch(sim, bitmap);
+}
+
+/* set interrupt sources. */
+void stpmic_sim_set_source(stpmic_sim_t* sim, uint32_t bitmap) {
+    for (uint8_t i = 0; i < 4; ++i) {
+        sim->regs[STPMIC_REG_INT_SRC_R1 + i] = (uint8_t)(bitmap >> (i << 3));
+    }
+}
+
+/* test whether the interrupt line (INTn) is asserted or not. */
+uint8_t stpmic_sim_irq(const stpmic_sim_t* sim) {
+    for (uint8_t i = 0; i < 4; ++i) {
+        if (sim->regs[STPMIC_REG_INT_PENDING_R1 + i]) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+#endif
@@ -0,0 +1,129 @@
+#ifndef __STPMIC_SIM_H__
+#define __STPMIC_SIM_H__
+
+#include "stpmic.h"
+
+/**
+ * STPMIC driver.
+ * --
+ * author: jay94ks@gmail.com
+ * repository: https://github.com/jay94ks/stpmic
+ * --
+ * Copyright(C) 2025, jay94ks.
+ * License: MIT.
+ *
+ * --
+ * simulated STPMIC1 device for host builds, STPMIC_USE_CHAN only.
+ * a pointer to `chan` of `stpmic_sim_t` must be passed to `stpmic_init` function.
+ *
+ *  stpmic_sim_t sim;
+ *
+ *  stpmic_sim_init(&sim, -1);
+ *  stpmic_sim_set_clock(&sim, 400000);
+ *  stpmic_init(&sim.chan, -1);
+ *
+ * --
+ * register model:
+ * 1. status registers, `INT_PENDING_Rx`, `INT_DBG_LATCH_Rx`, `INT_MASK_Rx`,
+ *    `INT_SRC_Rx` and `NVM_SR` are read-only. writes to them are ignored and counted.
+ * 2. `INT_CLEAR_Rx` clears pending bits written as 1, `INT_MASK_SET_Rx` and
+ *    `INT_MASK_CLEAR_Rx` set and clear `INT_MASK_Rx`. these read as zero.
+ * 3. `NVM_CR` starts an NVM operation, `NVM_SR` reads busy until `nvm_busy_ns` elapsed.
+ *    shadow registers are loaded from `nvm` on power-on and by NVM read command.
+ * 4. register address auto-increments for each byte, reads and writes.
+ * 5. `SWOFF` of `MAIN_CR` is a command: counted by `swoffs` and reads as zero.
+ *
+ * --
+ * latency model:
+ * each transfer costs `xfer_ns` + (conditions * `cond_ns`) + (bytes * `byte_ns`),
+ * bytes include address bytes. START, repeated-START and STOP are conditions.
+ * the cost is added to `now_ns` and passed to `delay` hook if set.
+ * `get_tick` of the channel returns `now_ns` in milliseconds, for deadlines.
+ * with zero latency, NVM operations complete at the next access.
+ */
+
+#if STPMIC_USE_CHAN
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* simulated STPMIC1 device. */
+typedef struct stpmic_sim_t {
+    stpmic_i2c_t        chan;       // --> I2C channel, pass this to `stpmic_init`.
+    uint8_t             addr;       // --> 7-bit device address.
+    uint8_t             ptr;        // --> register address pointer.
+    stpmic_reg_t        regs[STPMIC_REG_MAX];
+
+    /* non-volatile contents of `NVM_xxx_SHR` registers. */
+    stpmic_reg_t        nvm[STPMIC_REG_MAX - STPMIC_REG_NVM_MAIN_CTRL_SHR];
+
+    /* latency model. */
+    uint32_t            byte_ns;
+    uint32_t            cond_ns;
+    uint32_t            xfer_ns;
+    uint32_t            nvm_busy_ns;
+    uint64_t            now_ns;
+    uint64_t            nvm_done_ns;
+
+    /* delay hook to spend the latency in real time, optional. */
+    void                (*delay)(struct stpmic_sim_t*, uint32_t ns);
+
+    /* statistics. */
+    uint32_t            xfers;
+    uint32_t            bytes;
+    uint32_t            nacks;
+    uint32_t            ignored;    // --> writes to read-only registers.
+    uint32_t            swoffs;     // --> switch-off requests by `SWOFF` of `MAIN_CR`.
+} stpmic_sim_t;
+
+/**
+ * initialize the simulated device and power it on.
+ * latency is zero and `nvm` is zero except `I2C_ADDR_SHR`.
+ * @param sim device to initialize.
+ * @param addr I2C device address, `-1` to use default value.
+ */
+void stpmic_sim_init(stpmic_sim_t* sim, int16_t addr);
+
+/* set latency from I2C bus clock: 9 clocks per byte, 1 clock per condition. */
+void stpmic_sim_set_clock(stpmic_sim_t* sim, uint32_t hz);
+
+/* set latency per byte, per condition and per transfer, in nanoseconds. */
+void stpmic_sim_set_latency(stpmic_sim_t* sim, uint32_t byte_ns, uint32_t cond_ns, uint32_t xfer_ns);
+
+/* advance the modelled time without bus activity. */
+void stpmic_sim_advance(stpmic_sim_t* sim, uint32_t ns);
+
+/* reset statistics and the modelled time. */
+void stpmic_sim_reset_stats(stpmic_sim_t* sim);
+
+/**
+ * power the device on: registers are reset, shadow registers are loaded from `nvm`.
+ * @param sim device.
+ * @param turn_on_sr value of `TURN_ON_SR`, turn-on condition.
+ */
+void stpmic_sim_power_on(stpmic_sim_t* sim, stpmic_reg_t turn_on_sr);
+
+/**
+ * restart the device like power-on, but keeps `TURN_OFF_SR`.
+ * @param sim device.
+ * @param restart_sr value of `RESTART_SR`, restart condition.
+ */
+void stpmic_sim_restart(stpmic_sim_t* sim, stpmic_reg_t restart_sr);
+
+/**
+ * raise interrupt events, bits are same with `STPMIC_INTFLAG_xxx`.
+ * events are latched to `INT_DBG_LATCH_Rx` and unmasked ones to `INT_PENDING_Rx`.
+ */
+void stpmic_sim_raise(stpmic_sim_t* sim, uint32_t bitmap);
+
+/* set interrupt sources, bits are same with `STPMIC_INTSRC_xxx`. */
+void stpmic_sim_set_source(stpmic_sim_t* sim, uint32_t bitmap);
+
+/* test whether the interrupt line (INTn) is asserted or not. */
+uint8_t stpmic_sim_irq(const stpmic_sim_t* sim);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+#endif